@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Measures the rebuild time of batching groups on the recording render device.
+# See "Benchmarks" in the README.
+#
+#-------------------------------------------------
+
+QT       += core gui widgets
+CONFIG   += console
+CONFIG   -= app_bundle
+QMAKE_CXXFLAGS_WARN_ON -= -Wall
+
+TARGET = Mog2d-Bench
+TEMPLATE = app
+
+# no GL calls are made, the software renderer only provides the headers
+CONFIG += mog_software_renderer
+include(../Mog2d-Qt/mog2d_engine.pri)
+
+SOURCES += \
+        main.cpp
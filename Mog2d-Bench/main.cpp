@@ -0,0 +1,87 @@
+#include <QApplication>
+#include <algorithm>
+#include <stdio.h>
+#include "mog/Constants.h"
+#include "mog/mog.h"
+#include "mog/core/Engine.h"
+#include "mog/core/MogStats.h"
+#include "mog/core/RecordingRenderDevice.h"
+
+#define BENCH_WARMUP 3
+#define BENCH_RUNS 20
+#define BENCH_DEPTH 10
+
+using namespace mog;
+
+class BenchScene : public Scene {
+};
+
+class BenchApp : public AppBase {
+public:
+    shared_ptr<BenchScene> scene;
+
+    virtual void onLoad() override {
+        this->scene = make_shared<BenchScene>();
+        this->loadScene(this->scene);
+    }
+};
+
+// the children are spread over nested groups of the given depth, all of them built into one batch.
+static shared_ptr<Group> createBatchingGroup(int childrenNum, int depth) {
+    auto batchingGroup = Group::create(true);
+    auto group = batchingGroup;
+    for (int d = 0; d < depth; d++) {
+        int num = childrenNum / depth + (d < childrenNum % depth ? 1 : 0);
+        for (int i = 0; i < num; i++) {
+            auto rectangle = Rectangle::create(Size(8, 8));
+            rectangle->setPosition((i % 100) * 9, (i / 100 % 70) * 9);
+            rectangle->setColor(Color((i % 7) / 7.0f, (i % 11) / 11.0f, (i % 13) / 13.0f));
+            group->add(rectangle);
+        }
+        if (d + 1 < depth) {
+            auto child = Group::create();
+            group->add(child);
+            group = child;
+        }
+    }
+    return batchingGroup;
+}
+
+// rebuilds the whole batch every frame and prints the time of Group::bindBatch, taken from MogStats.
+// the recording device makes no GL calls, so only the CPU side of the rebuild is measured.
+int main(int argc, char *argv[]) {
+    QApplication a(argc, argv);
+
+    RenderDevice::setInstance(RecordingRenderDevice::create());
+    auto app = make_shared<BenchApp>();
+    auto engine = Engine::create(app);
+    engine->setDisplaySize(Size(960, 640));
+    engine->setScreenSizeBasedOnHeight(BASE_SCREEN_HEIGHT);
+    engine->startEngine();
+    engine->setStatsEnable(false);
+    map<unsigned int, TouchInput> touches;
+    // the scene is loaded in the first frame
+    engine->onDrawFrame(touches);
+
+    printf("%8s %6s %10s %10s\n", "children", "depth", "best ms", "median ms");
+    for (int depth : {1, BENCH_DEPTH}) {
+        for (int childrenNum : {100, 1000, 10000}) {
+            auto rootGroup = app->scene->getRootGroup();
+            rootGroup->removeAll();
+            auto group = createBatchingGroup(childrenNum, depth);
+            rootGroup->add(group);
+
+            vector<float> times;
+            for (int i = 0; i < BENCH_WARMUP + BENCH_RUNS; i++) {
+                group->setReRenderFlag(RERENDER_ALL);
+                engine->onDrawFrame(touches);
+                if (i >= BENCH_WARMUP) {
+                    times.emplace_back(MogStats::batchRebuildTime);
+                }
+            }
+            sort(times.begin(), times.end());
+            printf("%8d %6d %10.3f %10.3f\n", childrenNum, depth, times.front(), times[times.size() / 2]);
+        }
+    }
+    return 0;
+}
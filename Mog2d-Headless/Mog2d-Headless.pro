@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Renders a .mogui scene on the cpu and measures the frame times,
+# without a display or a GL driver. See "Headless renderer" in the README.
+#
+#-------------------------------------------------
+
+QT       += core gui widgets
+CONFIG   += console
+CONFIG   -= app_bundle
+QMAKE_CXXFLAGS_WARN_ON -= -Wall
+
+TARGET = Mog2d-Headless
+TEMPLATE = app
+
+CONFIG += mog_software_renderer
+include(../Mog2d-Qt/mog2d_engine.pri)
+
+SOURCES += \
+        main.cpp
+
+RESOURCES += \
+    ../Mog2d-Qt/assets.qrc
@@ -0,0 +1,211 @@
+#include <QApplication>
+#include <chrono>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include "mog/Constants.h"
+#include "mog/mog.h"
+#include "mog/core/Engine.h"
+#include "mog/core/MogUILoader.h"
+#include "mog/core/MogStats.h"
+#include "mog/core/SoftwareGL.h"
+
+using namespace mog;
+
+class HeadlessScene : public Scene {
+public:
+    shared_ptr<Entity> entity;
+
+    virtual void onLoad() override {
+        if (this->entity) {
+            this->add(this->entity);
+        }
+    }
+};
+
+// half transparent children over an opaque background. the children of the faded panel do not overlap,
+// a group drawn from its cache is composited as one layer where they do.
+static shared_ptr<Entity> createTranslucentEntity() {
+    auto background = Rectangle::create(Size(320, 240));
+    background->setColor(Color(0.2f, 0.6f, 0.2f, 1.0f));
+    
+    auto panel = Group::create();
+    panel->setPosition(20, 20);
+    auto red = Rectangle::create(Size(120, 80));
+    red->setColor(Color(1.0f, 0, 0, 0.5f));
+    auto blue = Rectangle::create(Size(120, 80));
+    blue->setPosition(60, 40);
+    blue->setColor(Color(0, 0, 1.0f, 0.5f));
+    panel->add(red);
+    panel->add(blue);
+    
+    auto fadedPanel = Group::create();
+    fadedPanel->setPosition(200, 20);
+    fadedPanel->setColor(Color(1.0f, 1.0f, 1.0f, 0.6f));
+    auto white = Rectangle::create(Size(80, 80));
+    white->setColor(Color(1.0f, 1.0f, 1.0f, 0.5f));
+    fadedPanel->add(white);
+    
+    auto root = Group::create();
+    root->add(background);
+    root->add(panel);
+    root->add(fadedPanel);
+    return root;
+}
+
+static void collectGroups(const shared_ptr<Entity> &entity, vector<shared_ptr<Group>> *groups) {
+    if (entity->getEntityType() != EntityType::Group) return;
+    auto group = static_pointer_cast<Group>(entity);
+    if (group->isEnableBatching()) return;
+    groups->emplace_back(group);
+    for (const auto &child : group->getChildEntities()) {
+        collectGroups(child, groups);
+    }
+}
+
+// loads the .mogui from the assets when it is there, otherwise from the file.
+// without a file, the built-in translucent scene is drawn.
+class HeadlessApp : public AppBase {
+public:
+    string filepath;
+    shared_ptr<Entity> entity;
+    bool loaded = false;
+
+    virtual void onLoad() override {
+        auto scene = make_shared<HeadlessScene>();
+        if (this->filepath.empty()) {
+            scene->entity = createTranslucentEntity();
+        } else if (FileUtils::existAsset(this->filepath)) {
+            scene->entity = MogUILoader::load(this->filepath);
+        } else {
+            scene->entity = MogUILoader::loadFile(this->filepath);
+        }
+        this->entity = scene->entity;
+        this->loaded = (scene->entity != nullptr);
+        this->loadScene(scene);
+    }
+};
+
+static void printUsage() {
+    fprintf(stderr, "usage: Mog2d-Headless [--size WIDTHxHEIGHT] [--frames N] [--warmup N] [--damage-tracking] [--compare-cache] [--out frame.png] [scene.mogui]\n");
+}
+
+// the warmup frames load the scene and upload its textures, they are not measured.
+// the frame times are printed in one line, and the last frame is written to the png.
+// with --compare-cache, the groups are drawn without and then from their caches, and the frames must match.
+int main(int argc, char *argv[]) {
+    QApplication a(argc, argv);
+
+    int width = 960;
+    int height = 640;
+    int frames = 1;
+    int warmup = 1;
+    bool damageTracking = false;
+    bool compareCache = false;
+    string out;
+    string filepath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--size" && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                printUsage();
+                return 2;
+            }
+        } else if (arg == "--frames" && hasValue) {
+            frames = max(1, atoi(argv[++i]));
+        } else if (arg == "--warmup" && hasValue) {
+            warmup = max(0, atoi(argv[++i]));
+        } else if (arg == "--damage-tracking") {
+            damageTracking = true;
+        } else if (arg == "--compare-cache") {
+            compareCache = true;
+        } else if (arg == "--out" && hasValue) {
+            out = argv[++i];
+        } else if (arg.compare(0, 2, "--") != 0 && filepath.empty()) {
+            filepath = arg;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if ((filepath.empty() && !compareCache) || width <= 0 || height <= 0) {
+        printUsage();
+        return 2;
+    }
+
+    auto app = make_shared<HeadlessApp>();
+    app->filepath = filepath;
+    auto engine = Engine::create(app);
+    // without damage tracking every frame is drawn in full, which is what the frame times measure
+    engine->setDamageTrackingEnable(damageTracking);
+    engine->setDisplaySize(Size(width, height));
+    engine->setScreenSizeBasedOnHeight(BASE_SCREEN_HEIGHT);
+    engine->startEngine();
+    engine->setStatsEnable(false);
+    if (!app->loaded) {
+        fprintf(stderr, "Mog2d-Headless: failed to load %s\n", filepath.c_str());
+        return 1;
+    }
+    vector<shared_ptr<Group>> groups;
+    if (compareCache) {
+        collectGroups(app->entity, &groups);
+        for (const auto &group : groups) {
+            group->setEnableCache(false);
+        }
+    }
+
+    map<unsigned int, TouchInput> touches;
+    for (int i = 0; i < warmup; i++) {
+        engine->onDrawFrame(touches);
+    }
+    vector<float> times;
+    int drawCallCount = 0;
+    for (int i = 0; i < frames; i++) {
+        auto startTime = chrono::steady_clock::now();
+        engine->onDrawFrame(touches);
+        auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime);
+        times.emplace_back(elapsed.count() / 1000.0f);
+        drawCallCount = MogStats::drawCallCount;
+    }
+
+    float total = 0;
+    for (float time : times) {
+        total += time;
+    }
+    sort(times.begin(), times.end());
+    printf("frames=%d avg=%.3fms p50=%.3fms p95=%.3fms max=%.3fms drawCalls=%d\n",
+           frames, total / frames, times[frames / 2], times[min(frames - 1, (int)(frames * 0.95f))], times.back(), drawCallCount);
+
+    if (compareCache) {
+        int w = 0;
+        int h = 0;
+        const unsigned char *pixels = SoftwareGL::getFramebuffer(&w, &h);
+        vector<unsigned char> uncached(pixels, pixels + w * h * 4);
+        for (const auto &group : groups) {
+            group->setEnableCache(true);
+        }
+        // the second frame is drawn from the caches filled by the first one
+        engine->onDrawFrame(touches);
+        engine->onDrawFrame(touches);
+        pixels = SoftwareGL::getFramebuffer(&w, &h);
+        // the alpha of the screen is not shown, and without a cache it holds the alpha multiplied by itself
+        int maxDiff = 0;
+        for (int i = 0; i < (int)uncached.size(); i++) {
+            if (i % 4 == 3) continue;
+            maxDiff = max(maxDiff, abs(pixels[i] - uncached[i]));
+        }
+        printf("cache groups=%d hits=%d maxDiff=%d\n", (int)groups.size(), MogStats::cacheHitCount, maxDiff);
+        // the cached texture rounds the colors to 8 bits once more
+        if (maxDiff > 2) {
+            fprintf(stderr, "Mog2d-Headless: the cached frame differs from the uncached frame by %d\n", maxDiff);
+            return 1;
+        }
+    }
+
+    if (!out.empty() && !SoftwareGL::writePNG(out)) {
+        fprintf(stderr, "Mog2d-Headless: failed to write %s\n", out.c_str());
+        return 1;
+    }
+    return 0;
+}
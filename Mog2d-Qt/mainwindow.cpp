@@ -3,8 +3,10 @@
 #include "origin.h"
 #include "mog/base/Entity.h"
 #include "mog/core/MogUILoader.h"
+#include "mog/core/TextureContainer.h"
 #include <QFileDialog>
 #include <QColorDialog>
+#include <QImage>
 
 const std::unordered_map<std::string, mog::EntityType> MainWindow::entityTypeMap = {
     {"Rectangle",           mog::EntityType::Rectangle},
@@ -39,6 +41,7 @@ MainWindow::MainWindow(QApplication &a, QWidget *parent) :
 
     this->ui->actionSave->setIcon(QApplication::style()->standardIcon(QStyle::SP_DialogSaveButton));
     this->connect(this->ui->actionSave, SIGNAL(triggered()), this, SLOT(saveFile()));
+    this->connect(this->ui->actionConvertTextures, SIGNAL(triggered()), this, SLOT(convertTextures()));
 
     this->ui->treeWidget_Entities->setTreeItemMoved([this](std::string name, std::string fromParent, std::string toParent) {
         if (fromParent != toParent) {
@@ -95,7 +98,61 @@ void MainWindow::saveFile() {
     QString dirPath = QDir(this->projectPath).filePath("assets");
     QString filepath = QFileDialog::getSaveFileName(this, "Save file", dirPath, "*.mogui");
     std::string rootName = this->ui->treeWidget_Entities->topLevelItem(0)->text(0).toStdString();
-    this->getApp()->saveUI(filepath.toStdString(), rootName);
+    auto atlasDict = this->bakeAtlas(filepath, rootName);
+    this->getApp()->saveUI(filepath.toStdString(), rootName, atlasDict);
+    this->initAssets();
+}
+
+// packs the images of the sprites into atlas pages for each density directory, so they are not packed at runtime.
+// the pages are written into the density directories of the assets, named after the ui file.
+mog::Dictionary MainWindow::bakeAtlas(QString filepath, std::string rootName) {
+    mog::Dictionary atlasDict;
+    QDir assetsDir = QDir(QDir(this->projectPath).filePath("assets"));
+    QFileInfo fileInfo(filepath);
+    QString relativeDir = assetsDir.relativeFilePath(fileInfo.absolutePath());
+    if (relativeDir.startsWith("..")) return atlasDict;
+    QString pagePrefix = fileInfo.completeBaseName() + "_atlas";
+    if (relativeDir != ".") {
+        pagePrefix = relativeDir + "/" + pagePrefix;
+    }
+
+    Platform platform = (Platform)(this->ui->comboBox_Platform->currentIndex() + 1);
+    for (const auto &density : mog::Density::allDensities) {
+        // only the images in the directory of the density are baked, the others are loaded at runtime
+        std::vector<std::shared_ptr<mog::Texture2D>> pages;
+        auto densityDict = this->getApp()->bakeUIAtlas(rootName, pagePrefix.toStdString(), [this, platform, density](std::string filename) {
+            std::string path = this->getAssetFilePath(platform, density.directory, filename);
+            if (path.length() == 0) return std::shared_ptr<mog::Texture2D>(nullptr);
+            return mog::Texture2D::createWithFile(path, density);
+        }, &pages);
+        if (pages.empty()) continue;
+
+        auto pagesArr = densityDict.get<mog::Array>(mog::MogUILoader::PropertyNames::AtlasPages);
+        QDir densityDir = QDir(assetsDir.filePath(QString(density.directory.c_str())));
+        for (int i = 0; i < pages.size(); i++) {
+            QString pagePath = densityDir.filePath(QString(pagesArr.at<mog::String>(i).value.c_str()));
+            QDir().mkpath(QFileInfo(pagePath).absolutePath());
+            QImage image(pages[i]->data, pages[i]->width, pages[i]->height, QImage::Format_RGBA8888);
+            image.save(pagePath, "PNG");
+            // the engine loads the container instead of decoding the png
+            mog::TextureContainer::write(pages[i], mog::TextureContainer::getContainerName(pagePath.toStdString()));
+        }
+        atlasDict.put(density.directory, densityDict);
+    }
+    return atlasDict;
+}
+
+// writes a .mogtex next to each image of the assets. the engine loads it instead of decoding the image.
+void MainWindow::convertTextures() {
+    int count = 0;
+    for (const auto &pair : this->assetsPathMap) {
+        auto texture = mog::Texture2D::createWithFile(pair.first);
+        if (texture->width == 0 || texture->height == 0) continue;
+        if (mog::TextureContainer::write(texture, mog::TextureContainer::getContainerName(pair.first))) {
+            count++;
+        }
+    }
+    this->ui->statusBar->showMessage(QString("%1 images converted").arg(count));
     this->initAssets();
 }
 
@@ -1194,6 +1251,19 @@ std::string MainWindow::getAssetFilePath(Platform platform, std::string filename
     return "";
 }
 
+std::string MainWindow::getAssetFilePath(Platform platform, std::string densityDir, std::string filename) {
+    std::vector<std::string> platformDirs = this->getAssetsPlatformDir(platform);
+    for (std::string platformDir : platformDirs) {
+        QString platformPath = QDir(this->projectPath).filePath(QString(platformDir.c_str()));
+        QString densityPath = QDir(platformPath).filePath(densityDir.c_str());
+        QString filePath = QDir(densityPath).filePath(QString(filename.c_str()));
+        if (QFile(filePath).exists()) {
+            return filePath.toStdString();
+        }
+    }
+    return "";
+}
+
 void MainWindow::platformChanged(int index) {
     this->initAssets();
 }
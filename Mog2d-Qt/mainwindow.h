@@ -32,6 +32,7 @@ public:
 private slots:
     void on_comboBox_CreateEntity_currentIndexChanged(int index);
     void saveFile();
+    void convertTextures();
     void entitiesItemSelectionChanged();
     void applicationStateChanged(Qt::ApplicationState state);
     void propertiesCellClicked(int row, int column);
@@ -138,6 +139,8 @@ private:
     bool isImageFile(QFileInfo fileInfo);
 
     std::string getAssetFilePath(Platform platform, std::string filename);
+    std::string getAssetFilePath(Platform platform, std::string densityDir, std::string filename);
+    mog::Dictionary bakeAtlas(QString filepath, std::string rootName);
     std::vector<std::string> getAssetsPlatformDir(Platform platform);
 };
 
@@ -11,14 +11,13 @@ cp -fr ../assets_qt ./assets_qt
 echo "<RCC>
     <qresource prefix=\"/\">" > assets.qrc
 
-FILES=`find assets -type f ! -name ".*"`
+# .mogtex containers are stored uncompressed, so they can be mapped in place
+FILES=`find assets assets_qt -type f ! -name ".*"`
 for f in ${FILES}; do
-    echo "        <file>$f</file>" >> assets.qrc
-done
-
-FILES=`find assets_qt -type f ! -name ".*"`
-for f in ${FILES}; do
-    echo "        <file>$f</file>" >> assets.qrc
+    case $f in
+        *.mogtex) echo "        <file threshold=\"100\">$f</file>" >> assets.qrc ;;
+        *) echo "        <file>$f</file>" >> assets.qrc ;;
+    esac
 done
 
 echo "    </qresource>
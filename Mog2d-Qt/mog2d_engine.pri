@@ -0,0 +1,138 @@
+# the engine sources shared by the designer and the headless renderer
+
+CONFIG   += c++11
+QMAKE_CXXFLAGS += -std=c++11
+DEFINES  += MOG_QT
+debug {
+    DEFINES += MOG_DEBUG
+}
+# qmake CONFIG+=mog_software_renderer renders on the cpu without a GL driver
+mog_software_renderer {
+    DEFINES += MOG_SOFTWARE_RENDERER
+}
+
+INCLUDEPATH += $$PWD/../classes/ $$PWD/../classes_qt/
+DEPENDPATH += $$PWD/../classes/ $$PWD/../classes_qt/
+
+SOURCES += \
+        $$PWD/../classes/mog/base/AppBase.cpp \
+        $$PWD/../classes/mog/base/Circle.cpp \
+        $$PWD/../classes/mog/base/DrawEntity.cpp \
+        $$PWD/../classes/mog/base/Entity.cpp \
+        $$PWD/../classes/mog/base/Group.cpp \
+        $$PWD/../classes/mog/base/Label.cpp \
+        $$PWD/../classes/mog/base/Polygon.cpp \
+        $$PWD/../classes/mog/base/Rectangle.cpp \
+        $$PWD/../classes/mog/base/RoundedRectangle.cpp \
+        $$PWD/../classes/mog/base/Scene.cpp \
+        $$PWD/../classes/mog/base/Slice9Sprite.cpp \
+        $$PWD/../classes/mog/base/Sprite.cpp \
+        $$PWD/../classes/mog/base/SpriteSheet.cpp \
+        $$PWD/../classes/mog/core/AudioPlayer.cpp \
+        $$PWD/../classes/mog/core/Collision.cpp \
+        $$PWD/../classes/mog/core/Data.cpp \
+        $$PWD/../classes/mog/core/DataStore.cpp \
+        $$PWD/../classes/mog/core/Engine.cpp \
+        $$PWD/../classes/mog/core/FileUtils.cpp \
+        $$PWD/../classes/mog/core/Http.cpp \
+        $$PWD/../classes/mog/core/mog_functions.cpp \
+        $$PWD/../classes/mog/core/NativePlugin.cpp \
+        $$PWD/../classes/mog/core/plain_objects.cpp \
+        $$PWD/../classes/mog/core/Preference.cpp \
+        $$PWD/../classes/mog/core/PubSub.cpp \
+        $$PWD/../classes/mog/core/Renderer.cpp \
+        $$PWD/../classes/mog/core/DrawBatcher.cpp \
+        $$PWD/../classes/mog/core/BatchBuilder.cpp \
+        $$PWD/../classes/mog/core/DamageTracker.cpp \
+        $$PWD/../classes/mog/core/RenderTarget.cpp \
+        $$PWD/../classes/mog/core/GLState.cpp \
+        $$PWD/../classes/mog/core/RenderDevice.cpp \
+        $$PWD/../classes/mog/core/GLRenderDevice.cpp \
+        $$PWD/../classes/mog/core/ShaderRenderDevice.cpp \
+        $$PWD/../classes/mog/core/RecordingRenderDevice.cpp \
+        $$PWD/../classes/mog/core/SoftwareGL.cpp \
+        $$PWD/../classes/mog/core/Texture2D.cpp \
+        $$PWD/../classes/mog/core/TextureAtlas.cpp \
+        $$PWD/../classes/mog/core/TextureLoader.cpp \
+        $$PWD/../classes/mog/core/TextureCache.cpp \
+        $$PWD/../classes/mog/core/TextureContainer.cpp \
+        $$PWD/../classes/mog/core/AssetManifest.cpp \
+        $$PWD/../classes/mog/core/TouchEventListener.cpp \
+        $$PWD/../classes/mog/core/Tween.cpp \
+        $$PWD/../classes/mog/core/MogStats.cpp \
+        $$PWD/../classes/mog/core/Density.cpp \
+        $$PWD/../classes/mog/core/MogUILoader.cpp \
+        $$PWD/../classes/mog/libs/sha256.cpp \
+        $$PWD/../classes/mog/libs/aes.c \
+        $$PWD/../classes/mog/libs/json.c \
+        $$PWD/../classes_qt/mog/core/mog_functions_native.cpp \
+        $$PWD/../classes_qt/mog/core/FileUtilsNative.cpp \
+        $$PWD/../classes_qt/mog/core/PreferenceNative.cpp \
+        $$PWD/../classes_qt/mog/core/Texture2DNative.cpp \
+        $$PWD/../classes_qt/mog/core/AudioPlayerNative.cpp \
+        $$PWD/../classes_qt/mog/core/Device.cpp
+
+HEADERS += \
+        $$PWD/../classes/mog/base/AppBase.h \
+        $$PWD/../classes/mog/base/Circle.h \
+        $$PWD/../classes/mog/base/DrawEntity.h \
+        $$PWD/../classes/mog/base/Entity.h \
+        $$PWD/../classes/mog/base/Group.h \
+        $$PWD/../classes/mog/base/Label.h \
+        $$PWD/../classes/mog/base/Polygon.h \
+        $$PWD/../classes/mog/base/Rectangle.h \
+        $$PWD/../classes/mog/base/RoundedRectangle.h \
+        $$PWD/../classes/mog/base/Scene.h \
+        $$PWD/../classes/mog/base/Slice9Sprite.h \
+        $$PWD/../classes/mog/base/Sprite.h \
+        $$PWD/../classes/mog/base/SpriteSheet.h \
+        $$PWD/../classes/mog/core/AudioPlayer.h \
+        $$PWD/../classes/mog/core/Collision.h \
+        $$PWD/../classes/mog/core/Data.h \
+        $$PWD/../classes/mog/core/DataStore.h \
+        $$PWD/../classes/mog/core/Engine.h \
+        $$PWD/../classes/mog/core/FileUtils.h \
+        $$PWD/../classes/mog/core/Http.h \
+        $$PWD/../classes/mog/core/KeyEvent.h \
+        $$PWD/../classes/mog/core/mog_functions.h \
+        $$PWD/../classes/mog/core/NativeClass.h \
+        $$PWD/../classes/mog/core/NativePlugin.h \
+        $$PWD/../classes/mog/core/plain_objects.h \
+        $$PWD/../classes/mog/core/Preference.h \
+        $$PWD/../classes/mog/core/PubSub.h \
+        $$PWD/../classes/mog/core/Renderer.h \
+        $$PWD/../classes/mog/core/DrawBatcher.h \
+        $$PWD/../classes/mog/core/BatchBuilder.h \
+        $$PWD/../classes/mog/core/DamageTracker.h \
+        $$PWD/../classes/mog/core/RenderTarget.h \
+        $$PWD/../classes/mog/core/GLState.h \
+        $$PWD/../classes/mog/core/RenderDevice.h \
+        $$PWD/../classes/mog/core/GLRenderDevice.h \
+        $$PWD/../classes/mog/core/ShaderRenderDevice.h \
+        $$PWD/../classes/mog/core/RecordingRenderDevice.h \
+        $$PWD/../classes/mog/core/SoftwareGL.h \
+        $$PWD/../classes/mog/core/Texture2D.h \
+        $$PWD/../classes/mog/core/TextureAtlas.h \
+        $$PWD/../classes/mog/core/TextureLoader.h \
+        $$PWD/../classes/mog/core/TextureCache.h \
+        $$PWD/../classes/mog/core/TextureContainer.h \
+        $$PWD/../classes/mog/core/AssetManifest.h \
+        $$PWD/../classes/mog/core/Touch.h \
+        $$PWD/../classes/mog/core/TouchEventListener.h \
+        $$PWD/../classes/mog/core/TouchInput.h \
+        $$PWD/../classes/mog/core/Transform.h \
+        $$PWD/../classes/mog/core/Tween.h \
+        $$PWD/../classes/mog/core/MogStats.h \
+        $$PWD/../classes/mog/core/Density.h \
+        $$PWD/../classes/mog/core/MogUILoader.h \
+        $$PWD/../classes/mog/libs/aes.h \
+        $$PWD/../classes/mog/libs/http.h \
+        $$PWD/../classes/mog/libs/json.h \
+        $$PWD/../classes/mog/libs/sha256.h \
+        $$PWD/../classes/mog/libs/stb_image.h \
+        $$PWD/../classes/mog/plugins/plugins.h \
+        $$PWD/../classes/mog/Constants.h \
+        $$PWD/../classes/mog/mog.h \
+        $$PWD/../classes_qt/mog/ConstantsNative.h \
+        $$PWD/../classes_qt/mog/core/mog_functions_native.h \
+        $$PWD/../classes_qt/mog/core/Device.h
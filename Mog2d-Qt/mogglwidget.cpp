@@ -9,6 +9,8 @@ MogGLWidget::MogGLWidget(QWidget* parent, const QGLWidget* shareWidget, Qt::Wind
     QGLFormat glFormat;
     glFormat.setVersion(1, 1);
     this->setFormat(glFormat);
+    // buffers are swapped only when the engine has drawn something
+    this->setAutoBufferSwap(false);
 }
 
 void MogGLWidget::initializeGL() {
@@ -31,7 +33,9 @@ void MogGLWidget::paintGL() {
         this->engineStarted = false;
     }
     this->makeCurrent();
-    this->engineController->drawFrame();
+    if (this->engineController->drawFrame()) {
+        this->swapBuffers();
+    }
 }
 
 void MogGLWidget::drawFrame() {
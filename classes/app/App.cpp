@@ -10,12 +10,22 @@ void App::onLoad() {
     this->loadScene(this->mainScene);
 }
 
-void App::saveUI(std::string filepath, std::string name) {
+void App::saveUI(std::string filepath, std::string name, const mog::Dictionary &atlasDict) {
     auto root = this->mainScene->getRootGroup()->findChildByName(name);
     auto uiDict = MogUILoader::serialize(root);
+    if (atlasDict.size() > 0) {
+        uiDict.put(MogUILoader::PropertyNames::Atlas, atlasDict);
+    }
     DataStore::serialize(filepath, uiDict);
 }
 
+mog::Dictionary App::bakeUIAtlas(std::string name, std::string pagePrefix,
+                                 std::function<std::shared_ptr<mog::Texture2D>(std::string filename)> loadTexture,
+                                 std::vector<std::shared_ptr<mog::Texture2D>> *pages) {
+    auto root = this->mainScene->getRootGroup()->findChildByName(name);
+    return MogUILoader::bakeAtlas(root, pagePrefix, loadTexture, pages);
+}
+
 std::string App::loadUI(std::string filepath) {
     auto root = this->mainScene->getRootGroup();
     auto uiDict = DataStore::deserialize<mog::Dictionary>(filepath);
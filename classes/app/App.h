@@ -11,7 +11,10 @@ namespace mog {
     public:
         void onLoad() override;
 
-        void saveUI(std::string filepath, std::string name);
+        void saveUI(std::string filepath, std::string name, const mog::Dictionary &atlasDict = mog::Dictionary());
+        mog::Dictionary bakeUIAtlas(std::string name, std::string pagePrefix,
+                                    std::function<std::shared_ptr<mog::Texture2D>(std::string filename)> loadTexture,
+                                    std::vector<std::shared_ptr<mog::Texture2D>> *pages);
         std::string loadUI(std::string filepath);
 
         void createEntity(EntityType entityType, std::string name, std::string parentName);
@@ -36,6 +36,7 @@
 #define RERENDER_COLOR      0b00000010
 #define RERENDER_TEXTURE    0b00000100
 #define RERENDER_TEX_COORDS 0b00001000
+#define RERENDER_TRANSFORM  0b00010000
 #define RERENDER_ALL        (RERENDER_VERTEX | RERENDER_COLOR | RERENDER_TEXTURE)
 
 #define DIRTY_POSITION      0b00000001
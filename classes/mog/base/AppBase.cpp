@@ -288,8 +288,11 @@ void AppBase::loadSceneWithSlideIn(const shared_ptr<Scene> &scene, Transition tr
 void AppBase::drawFrame(float delta) {
     if (this->currentScene) {
         auto engine = this->engine.lock();
-        this->currentScene->getRootGroup()->updateFrame(engine, delta);
-        this->currentScene->getRootGroup()->drawFrame(delta);
+        auto rootGroup = this->currentScene->getRootGroup();
+        rootGroup->updateFrame(engine, delta);
+        if (engine->beginDraw(rootGroup)) {
+            rootGroup->drawFrame(delta);
+        }
         
         if (this->doLoadScene()) {
             return;
@@ -48,6 +48,8 @@ void Circle::init(float radius) {
     }
     
     this->texture = Texture2D::createWithRGBA(data, radius, radius);
+    // only the alpha of the white mask is needed
+    this->texture->convert(TextureType::A8, false);
     this->rect = Rect(0, 0, this->texture->width, this->texture->height);
 }
 
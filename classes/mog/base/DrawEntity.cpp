@@ -21,9 +21,11 @@ void DrawEntity::bindVertex() {
     float *vertexTexCoords = new float[verticesNum * 2];
     int idx = 0;
     this->bindVertexTexCoords(vertexTexCoords, &idx, 0, 0, 1.0f, 1.0f);
-    if ((this->reRenderFlag & RERENDER_TEXTURE) == RERENDER_TEXTURE) {
+    // a texture shared by several entities, or uploaded by the loader, is uploaded once
+    if ((this->reRenderFlag & RERENDER_TEXTURE) == RERENDER_TEXTURE && this->texture->textureId == 0) {
         this->texture->bindTexture();
     }
+    this->renderer->premultipliedAlpha = this->texture->premultipliedAlpha;
     this->renderer->bindTextureVertex(this->texture->textureId, vertexTexCoords, verticesNum * 2, this->dynamicDraw);
     
     this->reRenderFlag &= ~(RERENDER_TEXTURE | RERENDER_TEX_COORDS);
@@ -4,6 +4,9 @@
 #include "mog/core/TouchEventListener.h"
 #include "mog/core/MogStats.h"
 #include "mog/core/Tween.h"
+#include "mog/core/DrawBatcher.h"
+#include "mog/core/DamageTracker.h"
+#include "mog/core/BatchBuilder.h"
 #include <math.h>
 
 using namespace mog;
@@ -41,24 +44,100 @@ void Entity::updateFrame(const shared_ptr<Engine> &engine, float delta) {
 }
 
 void Entity::drawFrame(float delta) {
+    this->hasWorldBounds = false;
     if (!this->visible) return;
     
-    if (this->reRenderFlag > 0) {
+    this->rebindVertex();
+    
+    this->renderer->pushMatrix();
+    this->renderer->pushColor();
+    this->renderer->applyTransform(this->transform, this->screenScale);
+    this->hasWorldBounds = this->renderer->getWorldBounds(this->worldBounds);
+    if (!this->hasWorldBounds || Renderer::isInCullRect(this->worldBounds)) {
+        DrawBatcher::getInstance()->add(this->renderer);
+    } else {
+        MogStats::culledCount++;
+    }
+    this->renderer->popColor();
+    this->renderer->popMatrix();
+}
+
+// adds the area covered in the last frame and the area to be covered in this frame.
+// geometry is rebuilt here, so the new bounds are known before the screen is cleared.
+void Entity::collectDamage(bool force) {
+    if (!force && !this->damaged && this->reRenderFlag == 0) return;
+    this->damaged = false;
+    
+    auto damageTracker = DamageTracker::getInstance();
+    if (this->hasWorldBounds) {
+        damageTracker->addDamage(this->worldBounds);
+    }
+    if (!this->visible) return;
+    
+    this->rebindVertex();
+    
+    float bounds[4];
+    this->renderer->pushMatrix();
+    this->renderer->applyTransform(this->transform, this->screenScale, false);
+    if (this->renderer->getWorldBounds(bounds)) {
+        damageTracker->addDamage(bounds);
+    }
+    this->renderer->popMatrix();
+}
+
+void Entity::rebindVertex() {
+    // transform changes are applied through the matrix, so only geometry changes are rebound
+    if ((this->reRenderFlag & ~RERENDER_TRANSFORM) > 0) {
         this->bindVertex();
-        this->reRenderFlag = 0;
     }
+    this->reRenderFlag = 0;
+}
+
+// extends the bounds with the area this entity covers under the current matrix.
+void Entity::unionBounds(float *bounds, bool *hasBounds) {
+    if (!this->visible) return;
+    
+    this->rebindVertex();
     
-    this->renderer->drawFrame(this->transform, this->screenScale);
+    float entityBounds[4];
+    this->renderer->pushMatrix();
+    this->renderer->applyTransform(this->transform, this->screenScale, false);
+    if (this->renderer->getWorldBounds(entityBounds)) {
+        if (!*hasBounds) {
+            memcpy(bounds, entityBounds, sizeof(float) * 4);
+            *hasBounds = true;
+        } else {
+            bounds[0] = min(bounds[0], entityBounds[0]);
+            bounds[1] = min(bounds[1], entityBounds[1]);
+            bounds[2] = max(bounds[2], entityBounds[2]);
+            bounds[3] = max(bounds[3], entityBounds[3]);
+        }
+    }
+    this->renderer->popMatrix();
+}
+
+// batched entities are never drawn by themselves, so their flags are cleared by the batching group.
+void Entity::addToBatch(BatchBuilder *batchBuilder, const Color &parentColor) {
+    this->reRenderFlag = 0;
+    this->batchRangeIndex = -1;
+    if (!this->visible) return;
+    this->batchRangeIndex = batchBuilder->add(this, parentColor);
+}
+
+bool Entity::updateBatch(BatchBuilder *batchBuilder, const Color &parentColor, unsigned char flag) {
+    flag |= this->reRenderFlag;
+    this->reRenderFlag = 0;
+    if (!this->visible) return true;
+    return batchBuilder->update(this, this->batchRangeIndex, parentColor, flag);
 }
 
 void Entity::extractEvent(const shared_ptr<Engine> &engine, float delta) {
-    auto self = static_pointer_cast<Entity>(shared_from_this());
-    
     if (this->touchEnable && (!this->swallowTouches || this->touchListeners.size() > 0)) {
-        engine->pushTouchableEntity(self);
+        engine->pushTouchableEntity(shared_from_this());
     }
     
     if (this->tweens.size() > 0) {
+        auto self = shared_from_this();
         for (const auto &m : this->tweens) {
             m.second->update(delta, self);
         }
@@ -165,11 +244,15 @@ void Entity::getIndiciesNum(int *num) {
 }
 
 void Entity::show() {
+    if (this->visible) return;
     this->visible = true;
+    this->setReRenderFlag(RERENDER_ALL);
 }
 
 void Entity::hide() {
+    if (!this->visible) return;
     this->visible = false;
+    this->setReRenderFlag(RERENDER_ALL);
 }
 
 void Entity::removeFromParent() {
@@ -181,23 +264,23 @@ void Entity::removeFromParent() {
 
 void Entity::setAnchor(const Point &position) {
     this->transform->anchor = position;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 void Entity::setAnchor(float x, float y) {
     this->transform->anchor.x = x;
     this->transform->anchor.y = y;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 void Entity::setAnchorX(float x) {
     this->transform->anchor.x = x;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 void Entity::setAnchorY(float y) {
     this->transform->anchor.y = y;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 Point Entity::getAnchor() {
@@ -214,26 +297,26 @@ float Entity::getAnchorY() {
 
 void Entity::setPosition(const Point &position) {
     this->position = position;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
 void Entity::setPosition(float x, float y) {
     this->position.x = x;
     this->position.y = y;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
 void Entity::setPositionX(float x) {
     this->position.x = x;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
 void Entity::setPositionY(float y) {
     this->position.y = y;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
@@ -271,26 +354,26 @@ Point Entity::getPositionFrom(float x, float y) {
 
 void Entity::setOrigin(Point origin) {
     this->origin = origin;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
 void Entity::setOrigin(float x, float y) {
     this->origin.x = x;
     this->origin.y = y;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
 void Entity::setOriginX(float x) {
     this->origin.x = x;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
 void Entity::setOriginY(float y) {
     this->origin.y = y;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
     this->dirtyFlag |= DIRTY_POSITION;
 }
 
@@ -308,28 +391,28 @@ float Entity::getOriginY() {
 
 void Entity::setScale(float scale) {
     this->setScale(Point(scale, scale));
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 void Entity::setScale(float scaleX, float scaleY) {
     this->transform->scale.x = scaleX;
     this->transform->scale.y = scaleY;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 void Entity::setScale(const Point &scale) {
     this->transform->scale = scale;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 void Entity::setScaleX(float scaleX) {
     this->transform->scale.x = scaleX;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 void Entity::setScaleY(float scaleY) {
     this->transform->scale.y = scaleY;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 Point Entity::getScale() {
@@ -346,7 +429,7 @@ float Entity::getScaleY() {
 
 void Entity::setRotation(float angle) {
     this->transform->rotation = angle;
-    this->setReRenderFlag(RERENDER_VERTEX);
+    this->setReRenderFlag(RERENDER_TRANSFORM);
 }
 
 float Entity::getRotation() {
@@ -456,6 +539,7 @@ Color Entity::getColor() {
 
 void Entity::setZIndex(int zIndex) {
     this->zIndex = zIndex;
+    this->damaged = true;
     if (auto group = this->group.lock()) {
         group->enableSortOrderDirty();
     }
@@ -650,8 +734,21 @@ shared_ptr<Collider> Entity::getCollider() {
 }
 
 void Entity::setReRenderFlag(unsigned char flag) {
+    this->damaged = true;
+    this->addReRenderFlag(flag);
+}
+
+// marks the parents without damaging them, they only need to be traversed.
+void Entity::addReRenderFlag(unsigned char flag) {
     if (auto group = this->group.lock()) {
-        group->setReRenderFlag(flag);
+        // a cached group renders its children again
+        group->dirtyCache = true;
+        // a batching group bakes the transforms of its children into the vertices
+        if ((flag & RERENDER_TRANSFORM) == RERENDER_TRANSFORM) {
+            group->addReRenderFlag((flag & ~RERENDER_TRANSFORM) | RERENDER_VERTEX);
+        } else {
+            group->addReRenderFlag(flag);
+        }
     }
     this->reRenderFlag |= flag;
 }
@@ -672,7 +769,7 @@ void Entity::copyFrom(const shared_ptr<Entity> &src) {
 void Entity::updatePositionAndSize() {
     if ((this->dirtyFlag & DIRTY_POSITION) == DIRTY_POSITION) {
         this->transform->position = this->getPositionFrom(Point::zero);
-        this->reRenderFlag |= RERENDER_VERTEX;
+        this->reRenderFlag |= RERENDER_TRANSFORM;
     }
     
     if ((this->dirtyFlag & DIRTY_SIZE) == DIRTY_SIZE) {
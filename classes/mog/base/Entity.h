@@ -20,6 +20,7 @@ extern void *enabler;
 namespace mog {
     class Engine;
     class Scene;
+    class BatchBuilder;
     class Group;
     class TouchEventListener;
     class Tween;
@@ -62,6 +63,10 @@ namespace mog {
         float screenScale = 1.0f;
         bool ratioWidth = false;
         bool ratioHeight = false;
+        bool hasWorldBounds = false;
+        float worldBounds[4] = {0, 0, 0, 0};
+        bool damaged = true;
+        int batchRangeIndex = -1;
         unordered_map<unsigned int, shared_ptr<TouchEventListener>> touchListeners;
         unordered_map<unsigned int, shared_ptr<Tween>> tweens;
         vector<unsigned int> tweenIdsToRemove;
@@ -77,17 +82,23 @@ namespace mog {
         virtual shared_ptr<AABB> getAABB();
         virtual void extractEvent(const shared_ptr<Engine> &engine, float delta);
         virtual void bindVertex();
+        virtual void rebindVertex();
+        virtual void unionBounds(float *bounds, bool *hasBounds);
+        virtual void addToBatch(BatchBuilder *batchBuilder, const Color &parentColor);
+        virtual bool updateBatch(BatchBuilder *batchBuilder, const Color &parentColor, unsigned char flag);
         virtual void onUpdate(float delta);
         virtual void copyFrom(const shared_ptr<Entity> &src);
         
         void setGroup(shared_ptr<Group> group);
         void updatePositionAndSize();
+        void addReRenderFlag(unsigned char flag);
 
     public:
         ~Entity();
 
         virtual void updateFrame(const shared_ptr<Engine> &engine, float delta);
         virtual void drawFrame(float delta);
+        virtual void collectDamage(bool force);
         virtual void updateMatrix();
         virtual bool contains(const Point &point);
         virtual bool collidesWith(const shared_ptr<Entity> &other);
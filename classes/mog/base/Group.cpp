@@ -2,7 +2,11 @@
 #include "mog/base/Group.h"
 #include "mog/base/Sprite.h"
 #include "mog/core/Engine.h"
+#include "mog/core/MogStats.h"
+#include "mog/core/DrawBatcher.h"
+#include "mog/core/DamageTracker.h"
 #include <algorithm>
+#include <chrono>
 
 using namespace mog;
 
@@ -25,42 +29,145 @@ bool Group::isEnableBatching() {
     return this->enableBatching;
 }
 
+// a cached group renders its children into a texture once and then draws a single quad.
+// the cache is only used by non batching groups.
+void Group::setEnableCache(bool enableCache) {
+    this->enableCache = enableCache;
+    this->dirtyCache = true;
+    if (!enableCache) {
+        this->renderTarget = nullptr;
+        this->cacheRenderer = nullptr;
+    }
+    this->setReRenderFlag(RERENDER_ALL);
+}
+
+bool Group::isEnableCache() {
+    return this->enableCache;
+}
+
+// the batching atlas is packed again from scratch with the new options.
+void Group::setEnableAtlasRotation(bool enableAtlasRotation) {
+    this->enableAtlasRotation = enableAtlasRotation;
+    this->textureAtlas = nullptr;
+    this->setReRenderFlag(RERENDER_ALL);
+}
+
+bool Group::isEnableAtlasRotation() {
+    return this->enableAtlasRotation;
+}
+
+// transparent borders of the textures are not stored in the atlas, the quads are clipped to the opaque area.
+void Group::setEnableAtlasTrimming(bool enableAtlasTrimming) {
+    this->enableAtlasTrimming = enableAtlasTrimming;
+    this->textureAtlas = nullptr;
+    this->setReRenderFlag(RERENDER_ALL);
+}
+
+bool Group::isEnableAtlasTrimming() {
+    return this->enableAtlasTrimming;
+}
+
+// for groups drawn scaled down, e.g. thumbnails or a zoomed out map.
+void Group::setEnableAtlasMipmap(bool enableAtlasMipmap) {
+    this->enableAtlasMipmap = enableAtlasMipmap;
+    this->textureAtlas = nullptr;
+    this->setReRenderFlag(RERENDER_ALL);
+}
+
+bool Group::isEnableAtlasMipmap() {
+    return this->enableAtlasMipmap;
+}
+
+// for groups whose children rarely change. the textures do not keep their pixels for a repack,
+// which then decodes them again.
+void Group::setEnableAtlasDataRelease(bool enableAtlasDataRelease) {
+    this->enableAtlasDataRelease = enableAtlasDataRelease;
+    if (this->textureAtlas) {
+        this->textureAtlas->enableDataRelease = enableAtlasDataRelease;
+    }
+}
+
+bool Group::isEnableAtlasDataRelease() {
+    return this->enableAtlasDataRelease;
+}
+
+// a compact type for the pages, e.g. RGBA4444 for a group of small sprites or A8 for masks.
+void Group::setAtlasTextureType(TextureType atlasTextureType) {
+    this->atlasTextureType = atlasTextureType;
+    this->textureAtlas = nullptr;
+    this->setReRenderFlag(RERENDER_ALL);
+}
+
+TextureType Group::getAtlasTextureType() {
+    return this->atlasTextureType;
+}
+
 void Group::updateFrame(const shared_ptr<Engine> &engine, float delta) {
     this->screenScale = engine->getScreenScale();
     this->updatePositionAndSize();
     this->extractEvent(engine, delta);
 
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    // children may add or remove entities while they are updated,
+    // so the draw list is not rebuilt until the traversal has finished.
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    this->traversalDepth++;
     for (const auto &entity : childEntitiesToDraw) {
         if ((this->dirtyFlag & DIRTY_SIZE) == DIRTY_SIZE) {
             entity->dirtyFlag |= (DIRTY_POSITION | DIRTY_SIZE);
         }
         entity->updateFrame(engine, delta);
     }
+    this->traversalDepth--;
     
     this->onUpdate(delta);
     this->dirtyFlag = 0;
 }
 
 void Group::drawFrame(float delta) {
+    this->hasWorldBounds = false;
     if (!this->visible) return;
     
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     
     if (this->enableBatching) {
-        if ((this->reRenderFlag & RERENDER_ALL) == RERENDER_ALL) {
-            this->bindVertex();
-            this->reRenderFlag = 0;
-        }
-        if (this->reRenderFlag > 0) {
-            this->bindVertexSub();
-            this->reRenderFlag = 0;
+        this->rebindVertex();
+        if (this->textureAtlas) {
+            MogStats::atlasUsedArea += this->textureAtlas->getUsedArea();
+            MogStats::atlasPageArea += this->textureAtlas->getPageArea();
         }
         
         Group::updateMatrix();
         
-        this->renderer->drawFrame(this->transform, this->screenScale);
+        this->renderer->pushMatrix();
+        this->renderer->pushColor();
+        this->renderer->applyTransform(this->transform, this->screenScale);
+        this->hasWorldBounds = this->renderer->getWorldBounds(this->worldBounds);
+        if (!this->hasWorldBounds || Renderer::isInCullRect(this->worldBounds)) {
+            // keep the draw order of the entities merged by the batcher
+            DrawBatcher::getInstance()->flush();
+            this->renderer->drawFrame();
+        } else {
+            MogStats::culledCount += (int)childEntitiesToDraw.size();
+        }
+        this->renderer->popColor();
+        this->renderer->popMatrix();
 
+    } else if (this->enableCache && this->renderCache(childEntitiesToDraw, delta)) {
+        this->renderer->pushMatrix();
+        this->renderer->pushColor();
+        this->renderer->applyTransform(this->transform, this->screenScale);
+        if (this->hasCacheBounds) {
+            this->hasWorldBounds = this->cacheRenderer->getWorldBounds(this->worldBounds);
+            if (!this->hasWorldBounds || Renderer::isInCullRect(this->worldBounds)) {
+                DrawBatcher::getInstance()->flush();
+                this->cacheRenderer->drawFrame();
+            } else {
+                MogStats::culledCount += this->contentEntitiesNum;
+            }
+        }
+        this->renderer->popColor();
+        this->renderer->popMatrix();
+        
     } else {
         if (this->reRenderFlag > 0 && (this->reRenderFlag & RERENDER_COLOR) == RERENDER_COLOR) {
             this->setReRenderFlagToChild(RERENDER_COLOR);
@@ -70,8 +177,19 @@ void Group::drawFrame(float delta) {
         this->renderer->pushColor();
         this->renderer->applyTransform(this->transform, this->screenScale);
         
-        for (const auto &entity : childEntitiesToDraw) {
-            entity->drawFrame(delta);
+        // skip the whole subtree while the content bounds of the last frame are off screen.
+        // content bounds are kept in local space, so moving the group itself does not invalidate them.
+        bool culled = false;
+        if (this->hasContentBounds && (this->reRenderFlag & RERENDER_VERTEX) == 0) {
+            Renderer::transformBounds(this->contentBounds, this->worldBounds);
+            this->hasWorldBounds = true;
+            culled = !Renderer::isInCullRect(this->worldBounds);
+        }
+        
+        if (culled) {
+            MogStats::culledCount += this->contentEntitiesNum;
+        } else {
+            this->drawChildEntities(childEntitiesToDraw, delta);
         }
         
         this->renderer->popColor();
@@ -81,53 +199,300 @@ void Group::drawFrame(float delta) {
     this->reRenderFlag = 0;
 }
 
-void Group::bindVertex() {
+// batched children are baked into one mesh, so a batching group is damaged as a whole.
+// otherwise only the changed children are damaged, unless the group itself has changed.
+void Group::collectDamage(bool force) {
     if (this->enableBatching) {
-        int indiciesNum = 0;
-        this->getIndiciesNum(&indiciesNum);
-        int verticesNum = 0;
-        this->getVerticesNum(&verticesNum);
-        
-        auto indices = new short[indiciesNum];
-        int idx = 0;
-        this->bindIndices(indices, &idx, 0);
-        auto vertices = new float[verticesNum * 2];
-        idx = 0;
-        
-        this->bindVertices(vertices, &idx, false);
-        this->renderer->bindVertex(vertices, verticesNum * 2, indices, indiciesNum, true);
-        
-        safe_delete_arr(indices);
-        safe_delete_arr(vertices);
-        
-        vector<shared_ptr<Texture2D>> textures;
-        this->textureAtlas = make_shared<TextureAtlas>();
-        this->addTextureTo(this->textureAtlas);
-        this->texture = this->textureAtlas->createTexture();
+        Entity::collectDamage(force);
+        return;
+    }
+    
+    // a cached group is redrawn as one quad
+    if (this->enableCache) {
+        if (!force && !this->damaged && this->reRenderFlag == 0) return;
+        this->damaged = false;
         
-        float *vertexTexCoords = new float[verticesNum * 2];
-        idx = 0;
-        this->bindVertexTexCoords(this->textureAtlas, vertexTexCoords, &idx, 0, 0, 1.0f, 1.0f);
-        this->textureAtlas->bindTexture();
-        this->renderer->bindTextureVertex(this->texture->textureId, vertexTexCoords, verticesNum * 2, true);
+        auto damageTracker = DamageTracker::getInstance();
+        if (this->hasWorldBounds) {
+            damageTracker->addDamage(this->worldBounds);
+        }
+        float bounds[4];
+        bool hasBounds = false;
+        this->unionBounds(bounds, &hasBounds);
+        if (hasBounds) {
+            damageTracker->addDamage(bounds);
+        }
+        return;
+    }
+    
+    if (!force && !this->damaged && this->reRenderFlag == 0) return;
+    bool forceChildren = (force || this->damaged);
+    this->damaged = false;
+    
+    if (!this->visible) {
+        if (this->hasWorldBounds) {
+            DamageTracker::getInstance()->addDamage(this->worldBounds);
+        }
+        return;
+    }
+    
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    this->renderer->pushMatrix();
+    this->renderer->applyTransform(this->transform, this->screenScale, false);
+    for (const auto &entity : childEntitiesToDraw) {
+        entity->collectDamage(forceChildren);
+    }
+    this->renderer->popMatrix();
+}
+
+void Group::rebindVertex() {
+    if ((this->reRenderFlag & RERENDER_ALL) == RERENDER_ALL) {
+        this->bindVertex();
+        this->reRenderFlag = 0;
+    }
+    if ((this->reRenderFlag & ~RERENDER_TRANSFORM) > 0) {
+        this->bindVertexSub();
+    }
+    this->reRenderFlag = 0;
+}
+
+void Group::unionBounds(float *bounds, bool *hasBounds) {
+    if (this->enableBatching) {
+        Entity::unionBounds(bounds, hasBounds);
+        return;
+    }
+    if (!this->visible) return;
+    
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    this->renderer->pushMatrix();
+    this->renderer->applyTransform(this->transform, this->screenScale, false);
+    for (const auto &entity : childEntitiesToDraw) {
+        entity->unionBounds(bounds, hasBounds);
+    }
+    this->renderer->popMatrix();
+}
+
+// renders the children into the render target when they have changed since the last frame.
+// the texture is laid out in the local pixel space of the group, so moving the group reuses it.
+// returns false when the render target can not be created, the cache is disabled then.
+// the color of the group only tints the quad, so fading the group reuses the texture too.
+bool Group::renderCache(const vector<shared_ptr<Entity>> &childEntitiesToDraw, float delta) {
+    if (!this->dirtyCache && (this->reRenderFlag & ~(RERENDER_TRANSFORM | RERENDER_COLOR)) == 0 && this->cacheScale == this->screenScale) {
+        MogStats::cacheHitCount++;
+        return true;
+    }
+    
+    this->renderer->pushMatrix();
+    this->renderer->pushColor();
+    this->renderer->setMatrix(Renderer::identityMatrix);
+    this->renderer->setColor(Color::white);
+    
+    float bounds[4];
+    this->hasCacheBounds = false;
+    for (const auto &entity : childEntitiesToDraw) {
+        entity->unionBounds(bounds, &this->hasCacheBounds);
+    }
+    
+    if (this->hasCacheBounds) {
+        float minX = floorf(bounds[0]);
+        float minY = floorf(bounds[1]);
+        float maxX = ceilf(bounds[2]);
+        float maxY = ceilf(bounds[3]);
+        int width = max((int)(maxX - minX), 1);
+        int height = max((int)(maxY - minY), 1);
         
-        safe_delete_arr(vertexTexCoords);
+        if (!this->renderTarget || this->renderTarget->width != width || this->renderTarget->height != height) {
+            this->renderTarget = RenderTarget::create(width, height);
+        }
+        if (!this->renderTarget) {
+            LOGE("Group::renderCache: failed to create a render target. width=%d, height=%d", width, height);
+            this->enableCache = false;
+            this->cacheRenderer = nullptr;
+            // the colors held back from the children while caching are applied again
+            this->setReRenderFlagToChild(RERENDER_COLOR);
+            this->renderer->popColor();
+            this->renderer->popMatrix();
+            return false;
+        }
         
-        float *vertexColors = new float[verticesNum * 4];
-        idx = 0;
-        this->bindVertexColors(vertexColors, &idx, this->getParentColor());
-        this->renderer->bindColorsVertex(vertexColors, verticesNum * 4, true);
+        this->renderTarget->begin();
+        float matrix[16];
+        memcpy(matrix, Renderer::identityMatrix, sizeof(float) * 16);
+        matrix[12] = -minX;
+        matrix[13] = -minY;
+        this->renderer->setMatrix(matrix);
+        this->drawChildEntities(childEntitiesToDraw, delta);
+        this->renderTarget->end();
         
-        safe_delete_arr(vertexColors);
+        // the top of the content is stored in the last row of the texture
+        vector<Vertex> vertices = {
+            {minX, minY, 0, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+            {minX, maxY, 0, 0, 1.0f, 1.0f, 1.0f, 1.0f},
+            {maxX, minY, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+            {maxX, maxY, 1.0f, 0, 1.0f, 1.0f, 1.0f, 1.0f},
+        };
+        vector<short> indices = {0, 1, 2, 3};
+        if (!this->cacheRenderer) {
+            this->cacheRenderer = make_shared<Renderer>();
+            this->cacheRenderer->premultipliedAlpha = true;
+        }
+        this->cacheRenderer->bindVertex(vertices, indices, this->renderTarget->textureId, false, false);
+    }
+    
+    this->renderer->popColor();
+    this->renderer->popMatrix();
+    
+    this->dirtyCache = false;
+    this->cacheScale = this->screenScale;
+    MogStats::cacheMissCount++;
+    return true;
+}
+
+void Group::drawChildEntities(const vector<shared_ptr<Entity>> &childEntitiesToDraw, float delta) {
+    this->hasWorldBounds = false;
+    this->contentEntitiesNum = 0;
+    for (const auto &entity : childEntitiesToDraw) {
+        entity->drawFrame(delta);
         
+        if (!entity->hasWorldBounds) continue;
+        if (!this->hasWorldBounds) {
+            memcpy(this->worldBounds, entity->worldBounds, sizeof(float) * 4);
+            this->hasWorldBounds = true;
+        } else {
+            this->worldBounds[0] = min(this->worldBounds[0], entity->worldBounds[0]);
+            this->worldBounds[1] = min(this->worldBounds[1], entity->worldBounds[1]);
+            this->worldBounds[2] = max(this->worldBounds[2], entity->worldBounds[2]);
+            this->worldBounds[3] = max(this->worldBounds[3], entity->worldBounds[3]);
+        }
+        if (entity->getEntityType() == EntityType::Group) {
+            auto group = static_cast<Group *>(entity.get());
+            this->contentEntitiesNum += group->enableBatching ? (int)group->childEntitiesToDraw.size() : group->contentEntitiesNum;
+        } else {
+            this->contentEntitiesNum++;
+        }
+    }
+    
+    this->hasContentBounds = this->hasWorldBounds;
+    if (this->hasContentBounds) {
+        Renderer::inverseTransformBounds(this->worldBounds, this->contentBounds);
+    }
+}
+
+void Group::bindVertex() {
+    if (this->enableBatching) {
+        this->bindBatch(true);
     } else {
         Entity::bindVertex();
     }
 }
 
+// rebuilds the whole mesh in one walk. textures are collected into the atlas only when one has changed.
+// the atlas is kept alive, so it only uploads the textures it has not seen before.
+void Group::bindBatch(bool rebuildTextureAtlas) {
+    auto startTime = chrono::steady_clock::now();
+    auto batchBuilder = BatchBuilder::getInstance();
+    
+    if (!this->textureAtlas) {
+        this->textureAtlas = make_shared<TextureAtlas>();
+        this->textureAtlas->enableRotation = this->enableAtlasRotation;
+        this->textureAtlas->enableTrimming = this->enableAtlasTrimming;
+        this->textureAtlas->enableMipmap = this->enableAtlasMipmap;
+        this->textureAtlas->enableDataRelease = this->enableAtlasDataRelease;
+        this->textureAtlas->textureType = this->atlasTextureType;
+        rebuildTextureAtlas = true;
+    }
+    batchBuilder->begin(rebuildTextureAtlas ? this->textureAtlas : nullptr);
+    
+    Color color = this->getParentColor() * this->transform->color;
+    this->renderer->pushMatrix();
+    this->renderer->setMatrix(Renderer::identityMatrix);
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    for (const auto &entity : childEntitiesToDraw) {
+        entity->addToBatch(batchBuilder, color);
+    }
+    this->renderer->popMatrix();
+    
+    // the pages are uploaded first, the draws of the batch refer to their texture ids
+    if (rebuildTextureAtlas) {
+        this->texture = this->textureAtlas->createTexture();
+        this->textureAtlas->bindTexture();
+    }
+    batchBuilder->mapTexCoords(this->textureAtlas);
+    this->renderer->bindVertex(batchBuilder->vertices, batchBuilder->indices, this->texture->textureId, true, true);
+    this->renderer->textureRanges.swap(batchBuilder->textureRanges);
+    this->batchRanges.swap(batchBuilder->ranges);
+    this->batchColor = color;
+    
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime);
+    MogStats::batchRebuildTime += elapsed.count() / 1000.0f;
+}
+
+// rewrites the ranges of the changed children only. returns false when the layout of the batch has changed.
+bool Group::bindBatchSub() {
+    auto startTime = chrono::steady_clock::now();
+    auto batchBuilder = BatchBuilder::getInstance();
+    batchBuilder->beginUpdate(this->renderer.get(), &this->batchRanges, this->textureAtlas);
+    
+    // the color of the group is baked into every vertex
+    Color color = this->getParentColor() * this->transform->color;
+    unsigned char flag = (color != this->batchColor) ? RERENDER_COLOR : 0;
+    this->renderer->pushMatrix();
+    this->renderer->setMatrix(Renderer::identityMatrix);
+    bool updated = this->updateChildBatch(batchBuilder, color, flag);
+    this->renderer->popMatrix();
+    this->batchColor = color;
+    
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime);
+    MogStats::batchRebuildTime += elapsed.count() / 1000.0f;
+    return updated;
+}
+
+bool Group::updateChildBatch(BatchBuilder *batchBuilder, const Color &color, unsigned char flag) {
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    for (const auto &entity : childEntitiesToDraw) {
+        if (flag == 0 && entity->reRenderFlag == 0) continue;
+        if (!entity->updateBatch(batchBuilder, color, flag)) return false;
+    }
+    return true;
+}
+
+void Group::addToBatch(BatchBuilder *batchBuilder, const Color &parentColor) {
+    this->reRenderFlag = 0;
+    if (!this->visible) return;
+    
+    Color color = parentColor * this->transform->color;
+    this->batchColor = color;
+    this->renderer->pushMatrix();
+    this->renderer->applyTransform(this->transform, this->screenScale, false);
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    for (const auto &entity : childEntitiesToDraw) {
+        entity->addToBatch(batchBuilder, color);
+    }
+    this->renderer->popMatrix();
+}
+
+// a moved or recolored group changes every leaf below it.
+bool Group::updateBatch(BatchBuilder *batchBuilder, const Color &parentColor, unsigned char flag) {
+    flag |= (this->reRenderFlag & RERENDER_TRANSFORM);
+    this->reRenderFlag = 0;
+    if (!this->visible) return true;
+    
+    // the color flag of a group may come from one of its children, so the baked color is compared instead
+    Color color = parentColor * this->transform->color;
+    if (color != this->batchColor) {
+        flag |= RERENDER_COLOR;
+    }
+    this->batchColor = color;
+    this->renderer->pushMatrix();
+    this->renderer->applyTransform(this->transform, this->screenScale, false);
+    bool updated = this->updateChildBatch(batchBuilder, color, flag & (RERENDER_TRANSFORM | RERENDER_COLOR));
+    this->renderer->popMatrix();
+    return updated;
+}
+
 void Group::getVerticesNum(int *num) {
     if (!this->visible) return;
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     for (auto &entity : childEntitiesToDraw) {
         entity->getVerticesNum(num);
     }
@@ -135,7 +500,7 @@ void Group::getVerticesNum(int *num) {
 
 void Group::getIndiciesNum(int *num) {
     if (!this->visible) return;
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     for (auto &entity : childEntitiesToDraw) {
         entity->getIndiciesNum(num);
     }
@@ -153,7 +518,7 @@ void Group::bindVertices(float *vertices, int *idx, bool bakeTransform) {
         this->renderer->setMatrix(Renderer::identityMatrix);
     }
     
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     for (auto &entity : childEntitiesToDraw) {
         entity->bindVertices(vertices, idx, true);
     }
@@ -169,7 +534,7 @@ void Group::bindVertices(float *vertices, int *idx, bool bakeTransform) {
 
 void Group::bindIndices(short *indices, int *idx, int start) {
     if (!this->visible) return;
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     for (auto &entity : childEntitiesToDraw) {
         entity->bindIndices(indices, idx, start);
         int verticesNum = 0;
@@ -178,33 +543,13 @@ void Group::bindIndices(short *indices, int *idx, int start) {
     }
 }
 
-void Group::bindVertexTexCoords(const shared_ptr<TextureAtlas> &textureAtlas,
-                                float *vertexTexCoords, int *idx, float x, float y, float w, float h) {
-    if (!this->visible) return;
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
-    for (auto &entity : childEntitiesToDraw) {
-        auto g = dynamic_cast<Group *>(entity.get());
-        if (g) {
-            g->bindVertexTexCoords(textureAtlas, vertexTexCoords, idx, x, y, w, h);
-            
-        } else {
-            auto cell = textureAtlas->getCell(entity->getTexture());
-            entity->bindVertexTexCoords(vertexTexCoords, idx,
-                                        (float)cell->x / textureAtlas->width,
-                                        (float)cell->y / textureAtlas->height,
-                                        (float)cell->width / textureAtlas->width,
-                                        (float)cell->height / textureAtlas->height);
-        }
-    }
-}
-
 void Group::bindVertexColors(float *vertexColors, int *idx, const Color &parentColor) {
     if (!this->visible) return;
     Color color = Color(parentColor.r * this->transform->color.r,
                         parentColor.g * this->transform->color.g,
                         parentColor.b * this->transform->color.b,
                         parentColor.a * this->transform->color.a);
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     for (auto &entity : childEntitiesToDraw) {
         entity->bindVertexColors(vertexColors, idx, color);
     }
@@ -214,39 +559,15 @@ void Group::bindVertexSub() {
     if (!this->visible) return;
     
     if (this->enableBatching) {
-        int verticesNum = 0;
-        this->getVerticesNum(&verticesNum);
-        
-        if ((this->reRenderFlag & RERENDER_VERTEX) == RERENDER_VERTEX) {
-            float *vertices = new float[verticesNum * 2];
-            int idx = 0;
-            this->bindVertices(vertices, &idx, false);
-            this->renderer->bindVertexSub(vertices, verticesNum * 2);
-            safe_delete_arr(vertices);
-            this->reRenderFlag &= ~RERENDER_VERTEX;
-        }
-        
-        if ((this->reRenderFlag & RERENDER_COLOR) == RERENDER_COLOR) {
-            float *vertexColors = new float[verticesNum * 4];
-            int idx = 0;
-            this->bindVertexColors(vertexColors, &idx, this->getParentColor());
-            this->renderer->bindColorsVertexSub(vertexColors, verticesNum * 4);
-            this->reRenderFlag &= ~RERENDER_COLOR;
-            safe_delete_arr(vertexColors);
-            this->reRenderFlag &= ~RERENDER_COLOR;
-        }
-        
-        if ((this->reRenderFlag & RERENDER_TEX_COORDS) == RERENDER_TEX_COORDS) {
-            float *vertexTexCoords = new float[verticesNum * 2];
-            int idx = 0;
-            this->bindVertexTexCoords(this->textureAtlas, vertexTexCoords, &idx, 0, 0, 1.0f, 1.0f);
-            this->renderer->bindTextureVertex(this->texture->textureId, vertexTexCoords, verticesNum * 2);
-            safe_delete_arr(vertexTexCoords);
-            this->reRenderFlag &= ~RERENDER_TEX_COORDS;
+        if ((this->reRenderFlag & RERENDER_TEXTURE) == RERENDER_TEXTURE) {
+            this->bindBatch(true);
+        } else if (!this->bindBatchSub()) {
+            this->bindBatch(false);
         }
+        this->reRenderFlag &= ~(RERENDER_VERTEX | RERENDER_COLOR | RERENDER_TEXTURE | RERENDER_TEX_COORDS);
         
     } else {
-        auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+        const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
         for (auto &entity : childEntitiesToDraw) {
             entity->bindVertexSub();
         }
@@ -288,32 +609,43 @@ void Group::add(const shared_ptr<Entity> &entity) {
     this->entityIdSet.insert((uintptr_t)entity.get());
     
     entity->setGroup(static_pointer_cast<Group>(shared_from_this()));
+    entity->damaged = true;
     this->sortOrderDirty = true;
-    this->setReRenderFlag(RERENDER_ALL);
+    this->addReRenderFlag(RERENDER_ALL);
 }
 
 void Group::remove(const shared_ptr<Entity> &entity) {
     this->childEntities.erase(std::remove(this->childEntities.begin(), this->childEntities.end(), entity), this->childEntities.end());
     this->sortOrderDirty = true;
-    this->setReRenderFlag(RERENDER_ALL);
+    this->addReRenderFlag(RERENDER_ALL);
+    if (entity->hasWorldBounds) {
+        DamageTracker::getInstance()->addDamage(entity->worldBounds);
+    }
     this->entityIdSet.erase((uintptr_t)entity.get());
     entity->setGroup(nullptr);
 }
 
 void Group::removeAll() {
+    for (const auto &entity : this->childEntities) {
+        if (entity->hasWorldBounds) {
+            DamageTracker::getInstance()->addDamage(entity->worldBounds);
+        }
+    }
     this->childEntities.clear();
-    this->childEntitiesToDraw.clear();
+    if (this->traversalDepth == 0) {
+        this->childEntitiesToDraw.clear();
+    }
     this->entityIdSet.clear();
     this->sortOrderDirty = true;
-    this->setReRenderFlag(RERENDER_ALL);
+    this->addReRenderFlag(RERENDER_ALL);
 }
 
 vector<shared_ptr<Entity>> Group::getChildEntities() {
     return this->childEntities;
 }
 
-vector<shared_ptr<Entity>> Group::getSortedChildEntitiesToDraw() {
-    if (this->sortOrderDirty) {
+const vector<shared_ptr<Entity>> &Group::getSortedChildEntitiesToDraw() {
+    if (this->sortOrderDirty && this->traversalDepth == 0) {
         this->sortChildEntitiesToDraw();
     }
     return this->childEntitiesToDraw;
@@ -351,7 +683,7 @@ vector<shared_ptr<Entity>> Group::findChildrenByTag(string tag, bool recursive)
 }
 
 void Group::addTextureTo(const shared_ptr<TextureAtlas> &textureAtlas) {
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     for (const auto &entity : childEntitiesToDraw) {
         entity->addTextureTo(textureAtlas);
     }
@@ -362,15 +694,21 @@ void Group::enableSortOrderDirty() {
     if (auto group = this->group.lock()) {
         group->enableSortOrderDirty();
     }
-    this->setReRenderFlag(RERENDER_ALL);
+    this->addReRenderFlag(RERENDER_ALL);
 }
 
+// a cached group renders its children in white, so a color from above is not passed down to them.
 void Group::setReRenderFlagToChild(unsigned char flag) {
-    auto childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
+    this->reRenderFlag |= flag;
+    if (this->enableCache) {
+        flag &= ~RERENDER_COLOR;
+        if (flag == 0) return;
+        this->dirtyCache = true;
+    }
+    const auto &childEntitiesToDraw = this->getSortedChildEntitiesToDraw();
     for (const auto &entity : childEntitiesToDraw) {
         entity->setReRenderFlagToChild(flag);
     }
-    this->reRenderFlag |= flag;
 }
 
 shared_ptr<Group> Group::clone() {
@@ -409,7 +747,7 @@ Color Group::getParentColor() {
 
 shared_ptr<Sprite> Group::createTextureSprite() {
     if (!this->textureAtlas) return nullptr;
-    return Sprite::createWithTexture(this->textureAtlas->texture);
+    return Sprite::createWithTexture(this->textureAtlas->getTexture(0));
 }
 
 
@@ -7,12 +7,16 @@
 #include <vector>
 #include "mog/core/plain_objects.h"
 #include "mog/core/TextureAtlas.h"
+#include "mog/core/RenderTarget.h"
+#include "mog/core/BatchBuilder.h"
 #include "mog/base/Entity.h"
 
 namespace mog {
     class Sprite;
     
     class Group : public Entity {
+        friend class Entity;
+
     public:
         static shared_ptr<Group> create(bool enableBatching = false);
         
@@ -22,6 +26,18 @@ namespace mog {
         vector<shared_ptr<Entity>> getChildEntities();
         void setEnableBatching(bool enableBatching);
         bool isEnableBatching();
+        void setEnableCache(bool enableCache);
+        bool isEnableCache();
+        void setEnableAtlasRotation(bool enableAtlasRotation);
+        bool isEnableAtlasRotation();
+        void setEnableAtlasTrimming(bool enableAtlasTrimming);
+        bool isEnableAtlasTrimming();
+        void setEnableAtlasMipmap(bool enableAtlasMipmap);
+        bool isEnableAtlasMipmap();
+        void setEnableAtlasDataRelease(bool enableAtlasDataRelease);
+        bool isEnableAtlasDataRelease();
+        void setAtlasTextureType(TextureType atlasTextureType);
+        TextureType getAtlasTextureType();
         
         shared_ptr<Entity> findChildByName(string name, bool recursive = true);
         vector<shared_ptr<Entity>> findChildrenByTag(string tag, bool recursive = true);
@@ -31,13 +47,13 @@ namespace mog {
         
         virtual void updateFrame(const shared_ptr<Engine> &engine, float delta) override;
         virtual void drawFrame(float delta) override;
+        virtual void collectDamage(bool force) override;
         virtual void updateMatrix() override;
         virtual void getVerticesNum(int *num) override;
         virtual void getIndiciesNum(int *num) override;
         virtual void bindVertices(float *vertices, int *idx, bool bakeTransform = false) override;
         virtual void bindIndices(short *indices, int *idx, int start) override;
         virtual void bindVertexSub() override;
-        virtual void bindVertexTexCoords(const shared_ptr<TextureAtlas> &textureAtlas, float *vertexTexCoords, int *idx, float x, float y, float w, float h);
         virtual void bindVertexColors(float *vertexColors, int *idx, const Color &parentColor = Color::white) override;
         virtual void setReRenderFlagToChild(unsigned char flag) override;
         
@@ -47,9 +63,26 @@ namespace mog {
 
     protected:
         bool sortOrderDirty = false;
+        int traversalDepth = 0;
         bool enableBatching = false;
+        bool hasContentBounds = false;
+        float contentBounds[4] = {0, 0, 0, 0};
+        int contentEntitiesNum = 0;
         unordered_map<unsigned long, shared_ptr<TextureAtlasCell>> cellMap;
         shared_ptr<TextureAtlas> textureAtlas;
+        bool enableAtlasRotation = false;
+        bool enableAtlasTrimming = false;
+        bool enableAtlasMipmap = false;
+        bool enableAtlasDataRelease = false;
+        TextureType atlasTextureType = TextureType::RGBA;
+        vector<BatchBuilder::Range> batchRanges;
+        Color batchColor = Color::white;
+        bool enableCache = false;
+        bool dirtyCache = true;
+        bool hasCacheBounds = false;
+        float cacheScale = 0;
+        shared_ptr<RenderTarget> renderTarget;
+        shared_ptr<Renderer> cacheRenderer;
 
         vector<shared_ptr<Entity>> childEntities;
         vector<shared_ptr<Entity>> childEntitiesToDraw;
@@ -58,10 +91,19 @@ namespace mog {
         Group();
         
         void sortChildEntitiesToDraw();
-        vector<shared_ptr<Entity>> getSortedChildEntitiesToDraw();
+        void drawChildEntities(const vector<shared_ptr<Entity>> &childEntitiesToDraw, float delta);
+        bool renderCache(const vector<shared_ptr<Entity>> &childEntitiesToDraw, float delta);
+        const vector<shared_ptr<Entity>> &getSortedChildEntitiesToDraw();
         shared_ptr<Sprite> createTextureSprite();
+        void bindBatch(bool rebuildTextureAtlas);
+        bool bindBatchSub();
+        bool updateChildBatch(BatchBuilder *batchBuilder, const Color &color, unsigned char flag);
 
         virtual void bindVertex() override;
+        virtual void rebindVertex() override;
+        virtual void unionBounds(float *bounds, bool *hasBounds) override;
+        virtual void addToBatch(BatchBuilder *batchBuilder, const Color &parentColor) override;
+        virtual bool updateBatch(BatchBuilder *batchBuilder, const Color &parentColor, unsigned char flag) override;
         virtual void copyFrom(const shared_ptr<Entity> &src) override;
         
     private:
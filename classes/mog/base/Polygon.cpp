@@ -12,7 +12,7 @@ void Polygon::init(const vector<Point> &vertexPoints) {
     this->vertexPoints = vertexPoints;
     
     if (!Polygon::sharedTexture) {
-        Polygon::sharedTexture = Texture2D::createWithColor(TextureType::RGBA, Color::white, 16, 16);
+        Polygon::sharedTexture = Texture2D::createWithColor(TextureType::A8, Color::white, 16, 16);
     }
     this->texture = Polygon::sharedTexture;
     
@@ -1,14 +1,13 @@
 #include "mog/base/RoundedRectangle.h"
 #include "mog/core/Engine.h"
 #include "mog/core/Device.h"
+#include "mog/core/TextureCache.h"
 #include <math.h>
 
 #define SCALABLE_RECT_SIZE 3
 
 using namespace mog;
 
-unordered_map<float, weak_ptr<Texture2D>> RoundedRectangle::cachedTexture2d;
-
 shared_ptr<RoundedRectangle> RoundedRectangle::create(const Size &size, float cornerRadius) {
     auto rectangle = shared_ptr<RoundedRectangle>(new RoundedRectangle());
     rectangle->init(size, false, cornerRadius);
@@ -25,9 +24,6 @@ RoundedRectangle::RoundedRectangle() {
 }
 
 RoundedRectangle::~RoundedRectangle() {
-    if (RoundedRectangle::cachedTexture2d.count(this->cornerRadius)) {
-        RoundedRectangle::cachedTexture2d.erase(this->cornerRadius);
-    }
 }
 
 float RoundedRectangle::getCornerRadius() {
@@ -38,15 +34,10 @@ void RoundedRectangle::init(const Size &size, bool isRatio, float cornerRadius)
     this->cornerRadius = cornerRadius;
     this->setSize(size, isRatio);
 
-    if (RoundedRectangle::cachedTexture2d.count(cornerRadius) > 0) {
-        this->texture = RoundedRectangle::cachedTexture2d[cornerRadius].lock();
-    }
-    if (this->texture == nullptr) {
-        this->texture = this->createTexture(cornerRadius);
-        if (this->texture) {
-            RoundedRectangle::cachedTexture2d[cornerRadius] = this->texture;
-        }
-    }
+    string key = TextureCache::getKey("RoundedRectangle", to_string(cornerRadius));
+    this->texture = TextureCache::getInstance()->getOrCreate(key, [this, cornerRadius]() {
+        return this->createTexture(cornerRadius);
+    });
     this->rect = Rect(0, 0, this->texture->width, this->texture->height);
 }
 
@@ -95,7 +86,10 @@ shared_ptr<Texture2D> RoundedRectangle::createTexture(float cornerRadius) {
         }
     }
     
-    return Texture2D::createWithRGBA(data, wh, wh, den);
+    // only the alpha of the white mask is needed
+    auto texture = Texture2D::createWithRGBA(data, wh, wh, den);
+    texture->convert(TextureType::A8, false);
+    return texture;
 }
 
 void RoundedRectangle::getVerticesNum(int *num) {
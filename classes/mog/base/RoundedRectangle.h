@@ -2,7 +2,6 @@
 #define RoundedRectangle_h
 
 #include <memory>
-#include <unordered_map>
 #include "mog/base/Sprite.h"
 #include "mog/core/plain_objects.h"
 
@@ -25,7 +24,6 @@ namespace mog {
         virtual EntityType getEntityType() override;
 
     protected:
-        static unordered_map<float, weak_ptr<Texture2D>> cachedTexture2d;
         float cornerRadius = 0;
         
         RoundedRectangle();
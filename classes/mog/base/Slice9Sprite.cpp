@@ -16,6 +16,7 @@ void Slice9Sprite::init(const shared_ptr<Sprite> sprite, const Rect &centerRect)
     this->transform->size = sprite->getSize();
     this->size = this->transform->size;
     this->rect = sprite->getRect();
+    this->textureOffset = sprite->getTextureOffset();
     this->centerRect = centerRect;
 }
 
@@ -107,8 +108,8 @@ void Slice9Sprite::bindVertexTexCoords(float *vertexTexCoords, int *idx, float x
     if (!this->visible) return;
     
     Size texSize = Size(this->texture->width, this->texture->height) / this->texture->density.value;
-    x += (this->rect.position.x / texSize.width) * w;
-    y += (this->rect.position.y / texSize.height) * h;
+    x += ((this->textureOffset.x + this->rect.position.x) / texSize.width) * w;
+    y += ((this->textureOffset.y + this->rect.position.y) / texSize.height) * h;
 
     float xx[4] = {
         x,
@@ -159,6 +160,7 @@ void Slice9Sprite::copyFrom(const shared_ptr<Entity> &src) {
     this->texture = srcSprite->getTexture();
     this->transform->size = srcSprite->getSize();
     this->rect = srcSprite->getRect();
+    this->textureOffset = srcSprite->getTextureOffset();
 }
 
 EntityType Slice9Sprite::getEntityType() {
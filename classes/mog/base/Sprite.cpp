@@ -1,11 +1,12 @@
 #include "mog/Constants.h"
 #include "mog/base/Sprite.h"
 #include "mog/core/Engine.h"
+#include "mog/core/TextureLoader.h"
+#include "mog/core/TextureCache.h"
 
 using namespace mog;
 
-unordered_map<string, weak_ptr<Texture2D>> Sprite::cachedTexture2d;
-unordered_map<string, weak_ptr<Texture2D>> Sprite::globalCachedTexture2d;
+weak_ptr<Texture2D> Sprite::placeholderTexture;
 
 shared_ptr<Sprite> Sprite::create(string filename) {
     auto sprite = shared_ptr<Sprite>(new Sprite());
@@ -53,30 +54,56 @@ shared_ptr<Sprite> Sprite::createWithTexture(const shared_ptr<Texture2D> &textur
     return sprite;
 }
 
+// the region is in points of the page texture. rect stays relative to the original image.
+shared_ptr<Sprite> Sprite::createWithAtlasRegion(string filename, const Rect &rect, const shared_ptr<Texture2D> &texture, const Rect &region) {
+    auto sprite = shared_ptr<Sprite>(new Sprite());
+    sprite->initWithAtlasRegion(filename, rect, texture, region);
+    return sprite;
+}
+
+shared_ptr<Sprite> Sprite::createAsync(string filename, function<void(const shared_ptr<Sprite> &sprite)> callback) {
+    auto sprite = shared_ptr<Sprite>(new Sprite());
+    sprite->initAsync(filename, Rect::zero, callback);
+    return sprite;
+}
+
+shared_ptr<Sprite> Sprite::createAsync(string filename, const Rect &rect, function<void(const shared_ptr<Sprite> &sprite)> callback) {
+    auto sprite = shared_ptr<Sprite>(new Sprite());
+    sprite->initAsync(filename, rect, callback);
+    return sprite;
+}
+
+shared_ptr<Texture2D> Sprite::getPlaceholderTexture() {
+    auto texture = Sprite::placeholderTexture.lock();
+    if (!texture) {
+        texture = Texture2D::createWithColor(TextureType::RGBA, Color::transparent, 1, 1);
+        Sprite::placeholderTexture = texture;
+    }
+    return texture;
+}
+
 void Sprite::registerCache(string filename) {
-    auto texture = Texture2D::createWithAsset(filename);
+    string key = TextureCache::getKey(filename);
+    auto texture = TextureCache::getInstance()->getOrCreate(key, [filename]() {
+        return Texture2D::createWithAsset(filename);
+    });
     if (texture) {
-        Sprite::globalCachedTexture2d[filename] = texture;
+        TextureCache::getInstance()->pin(key);
     }
 }
 
 void Sprite::removeCache(string filename) {
-    if (Sprite::globalCachedTexture2d.count(filename) > 0) {
-        Sprite::globalCachedTexture2d.erase(filename);
-    }
+    TextureCache::getInstance()->unpin(TextureCache::getKey(filename));
 }
 
 void Sprite::clearCache() {
-    Sprite::globalCachedTexture2d.clear();
+    TextureCache::getInstance()->clear();
 }
 
 Sprite::Sprite() {
 }
 
 Sprite::~Sprite() {
-    if (this->filename.size() > 0 && Sprite::cachedTexture2d.count(this->filename) > 0) {
-        Sprite::cachedTexture2d.erase(this->filename);
-    }
 }
 
 string Sprite::getFilename() {
@@ -87,17 +114,19 @@ Rect Sprite::getRect() {
     return this->rect;
 }
 
+Point Sprite::getTextureOffset() {
+    return this->textureOffset;
+}
+
+bool Sprite::isLoaded() {
+    return this->loaded;
+}
+
 void Sprite::init(string filename, const Rect &rect) {
     this->filename = filename;
-    if (Sprite::cachedTexture2d.count(filename) > 0) {
-        this->texture = Sprite::cachedTexture2d[filename].lock();
-    }
-    if (this->texture == nullptr) {
-        this->texture = Texture2D::createWithAsset(filename);
-        if (this->texture) {
-            Sprite::cachedTexture2d[filename] = this->texture;
-        }
-    }
+    this->texture = TextureCache::getInstance()->getOrCreate(TextureCache::getKey(filename), [filename]() {
+        return Texture2D::createWithAsset(filename);
+    });
     
     Rect _rect = rect;
     if (rect.size == Size::zero) {
@@ -150,6 +179,70 @@ void Sprite::initWithTexture(const shared_ptr<Texture2D> &texture) {
     this->rect = Rect(Point::zero, this->size);
 }
 
+void Sprite::initWithAtlasRegion(string filename, const Rect &rect, const shared_ptr<Texture2D> &texture, const Rect &region) {
+    this->filename = filename;
+    this->texture = texture;
+    this->textureOffset = region.position;
+    
+    Rect _rect = rect;
+    if (rect.size == Size::zero) {
+        _rect.size = region.size;
+    }
+    this->rect = _rect;
+    this->size = _rect.size;
+    this->transform->size = this->rect.size;
+}
+
+// a transparent placeholder is drawn until the texture is ready. the size stays zero unless a rect is given.
+void Sprite::initAsync(string filename, const Rect &rect, function<void(const shared_ptr<Sprite> &sprite)> callback) {
+    this->filename = filename;
+    this->texture = Sprite::getPlaceholderTexture();
+    this->loaded = false;
+    this->rect = rect;
+    this->size = rect.size;
+    this->transform->size = rect.size;
+    
+    weak_ptr<Sprite> weakSelf = static_pointer_cast<Sprite>(shared_from_this());
+    auto onLoaded = [weakSelf, rect, callback](const shared_ptr<Texture2D> &texture) {
+        auto self = weakSelf.lock();
+        if (!self) return;
+        if (texture) {
+            self->onTextureLoaded(texture, rect);
+        }
+        if (callback) {
+            callback(self);
+        }
+    };
+    
+    auto cachedTexture = TextureCache::getInstance()->get(TextureCache::getKey(filename));
+    if (cachedTexture) {
+        TextureLoader::getInstance()->deliver(cachedTexture, onLoaded);
+    } else {
+        TextureLoader::getInstance()->loadAsset(filename, onLoaded);
+    }
+}
+
+void Sprite::onTextureLoaded(const shared_ptr<Texture2D> &texture, const Rect &rect) {
+    string key = TextureCache::getKey(this->filename);
+    if (TextureCache::getInstance()->get(key) != texture) {
+        TextureCache::getInstance()->put(key, texture);
+    }
+    this->texture = texture;
+    this->loaded = true;
+    
+    Rect _rect = rect;
+    if (rect.size == Size::zero) {
+        _rect.size = Size(this->texture->width / this->texture->density.value,
+                          this->texture->height / this->texture->density.value);
+    }
+    this->rect = _rect;
+    this->size = _rect.size;
+    this->transform->size = this->rect.size;
+    
+    this->reRenderFlag |= RERENDER_ALL;
+    this->setReRenderFlag(RERENDER_ALL);
+}
+
 shared_ptr<Sprite> Sprite::clone() {
     auto entity = this->cloneEntity();
     return static_pointer_cast<Sprite>(entity);
@@ -162,9 +255,14 @@ shared_ptr<Entity> Sprite::cloneEntity() {
 }
 
 void Sprite::bindVertexTexCoords(float *vertexTexCoords, int *idx, float x, float y, float w, float h) {
+    if (!this->loaded) {
+        // every corner samples the single pixel of the placeholder
+        DrawEntity::bindVertexTexCoords(vertexTexCoords, idx, 0.5f, 0.5f, 0, 0);
+        return;
+    }
     Size texSize = Size(this->texture->width, this->texture->height) / this->texture->density.value;
-    x += this->rect.position.x / texSize.width;
-    y += this->rect.position.y / texSize.height;
+    x += (this->textureOffset.x + this->rect.position.x) / texSize.width;
+    y += (this->textureOffset.y + this->rect.position.y) / texSize.height;
     w *= this->rect.size.width / texSize.width;
     h *= this->rect.size.height / texSize.height;
     DrawEntity::bindVertexTexCoords(vertexTexCoords, idx, x, y, w, h);
@@ -175,6 +273,10 @@ void Sprite::copyFrom(const shared_ptr<Entity> &src) {
     auto srcSprite = static_pointer_cast<Sprite>(src);
     this->filename = srcSprite->filename;
     this->rect = srcSprite->rect;
+    this->textureOffset = srcSprite->textureOffset;
+    if (!srcSprite->loaded) {
+        this->initAsync(srcSprite->filename, srcSprite->rect, nullptr);
+    }
 }
 
 EntityType Sprite::getEntityType() {
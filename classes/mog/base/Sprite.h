@@ -3,7 +3,7 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <functional>
 #include "mog/base/Scene.h"
 #include "mog/base/Group.h"
 #include "mog/base/DrawEntity.h"
@@ -23,6 +23,10 @@ namespace mog {
         static shared_ptr<Sprite> createWithImage(const Bytes &bytes);
         static shared_ptr<Sprite> createWithRGBA(unsigned char *data, int width, int height);
         static shared_ptr<Sprite> createWithTexture(const shared_ptr<Texture2D> &texture);
+        static shared_ptr<Sprite> createWithAtlasRegion(string filename, const Rect &rect, const shared_ptr<Texture2D> &texture, const Rect &region);
+        // the image is decoded in the background. the sprite draws nothing until the callback is invoked.
+        static shared_ptr<Sprite> createAsync(string filename, function<void(const shared_ptr<Sprite> &sprite)> callback = nullptr);
+        static shared_ptr<Sprite> createAsync(string filename, const Rect &rect, function<void(const shared_ptr<Sprite> &sprite)> callback = nullptr);
         
         static void registerCache(string filename);
         static void removeCache(string filename);
@@ -30,6 +34,8 @@ namespace mog {
         
         string getFilename();
         Rect getRect();
+        Point getTextureOffset();
+        bool isLoaded();
         shared_ptr<Sprite> clone();
         virtual shared_ptr<Entity> cloneEntity() override;
         virtual EntityType getEntityType() override;
@@ -39,16 +45,22 @@ namespace mog {
     protected:
         Sprite();
         
-        static unordered_map<string, weak_ptr<Texture2D>> cachedTexture2d;
-        static unordered_map<string, weak_ptr<Texture2D>> globalCachedTexture2d;
+        static weak_ptr<Texture2D> placeholderTexture;
         string filename;
         Rect rect = Rect::zero;
+        // the position of the image in its texture, when it is a region of a baked atlas page
+        Point textureOffset = Point::zero;
+        bool loaded = true;
         
         void init(string filename, const Rect &rect);
         void initWithFilePath(string filepath, const Rect &rect, Density density);
         void initWithImage(unsigned char *image, int length);
         void initWithRGBA(unsigned char *data, int width, int height);
         void initWithTexture(const shared_ptr<Texture2D> &texture);
+        void initWithAtlasRegion(string filename, const Rect &rect, const shared_ptr<Texture2D> &texture, const Rect &region);
+        void initAsync(string filename, const Rect &rect, function<void(const shared_ptr<Sprite> &sprite)> callback);
+        void onTextureLoaded(const shared_ptr<Texture2D> &texture, const Rect &rect);
+        static shared_ptr<Texture2D> getPlaceholderTexture();
 
         virtual void bindVertexTexCoords(float *vertexTexCoords, int *idx, float x, float y, float w, float h) override;
         virtual void copyFrom(const shared_ptr<Entity> &src) override;
@@ -18,6 +18,7 @@ void SpriteSheet::init(const shared_ptr<Sprite> sprite, const Size &frameSize, u
     this->transform->size = frameSize;
     this->size = frameSize;
     this->rect = sprite->getRect();
+    this->textureOffset = sprite->getTextureOffset();
     this->frameSize = frameSize;
     
     this->initFrames(frameCount, margin);
@@ -143,8 +144,8 @@ void SpriteSheet::bindVertexTexCoords(float *vertexTexCoords, int *idx, float x,
     if (!this->visible) return;
 
     Size texSize = Size(this->texture->width, this->texture->height) / this->texture->density.value;
-    x += this->rect.position.x / texSize.width;
-    y += this->rect.position.y / texSize.height;
+    x += (this->textureOffset.x + this->rect.position.x) / texSize.width;
+    y += (this->textureOffset.y + this->rect.position.y) / texSize.height;
     
     auto p = this->framePoints[this->frame];
     x += (p.x / texSize.width) * w;
@@ -203,6 +204,7 @@ void SpriteSheet::copyFrom(const shared_ptr<Entity> &src) {
     this->filename = srcSprite->getFilename();
     this->transform->size = srcSprite->getSize();
     this->rect = srcSprite->getRect();
+    this->textureOffset = srcSprite->getTextureOffset();
     this->frameSize = srcSprite->getFrameSize();
     this->frameCount = srcSprite->getFrameCount();
     this->margin = srcSprite->getMargin();
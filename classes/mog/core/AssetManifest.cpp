@@ -0,0 +1,86 @@
+#include "mog/Constants.h"
+#include "mog/core/AssetManifest.h"
+#include "mog/core/FileUtils.h"
+#include <algorithm>
+
+using namespace mog;
+
+AssetManifest *AssetManifest::instance;
+
+AssetManifest *AssetManifest::getInstance() {
+    if (AssetManifest::instance == nullptr) {
+        AssetManifest::instance = new AssetManifest();
+    }
+    return AssetManifest::instance;
+}
+
+vector<Density> AssetManifest::getDensityOrder() {
+    Density current = Density::getCurrent();
+    vector<Density> higher;
+    vector<Density> lower;
+    for (const auto &density : Density::allDensities) {
+        if (density.value > current.value) {
+            higher.emplace_back(density);
+        } else if (density.value < current.value) {
+            lower.emplace_back(density);
+        }
+    }
+    reverse(lower.begin(), lower.end());
+
+    vector<Density> densities = {current};
+    densities.insert(densities.end(), higher.begin(), higher.end());
+    densities.insert(densities.end(), lower.begin(), lower.end());
+    return densities;
+}
+
+// a file under a density directory is an asset of that density. the other files are 1x assets,
+// used when no density has the asset.
+bool AssetManifest::build() {
+    vector<pair<string, int>> assets;
+    if (!FileUtils::listAssets(&assets)) return false;
+
+    auto densities = AssetManifest::getDensityOrder();
+    unordered_map<string, int> ranks;
+    this->entries.clear();
+    this->paths.clear();
+    for (const auto &asset : assets) {
+        this->paths.insert(asset.first);
+        string name = asset.first;
+        int rank = (int)densities.size();
+        Density density = Density::x1_0;
+        for (int i = 0; i < densities.size(); i++) {
+            string prefix = densities[i].directory + "/";
+            if (name.compare(0, prefix.length(), prefix) == 0) {
+                name = name.substr(prefix.length());
+                rank = i;
+                density = densities[i];
+                break;
+            }
+        }
+
+        auto it = ranks.find(name);
+        if (it != ranks.end() && it->second <= rank) continue;
+        ranks[name] = rank;
+        Entry entry;
+        entry.path = asset.first;
+        entry.size = asset.second;
+        entry.density = density;
+        this->entries[name] = entry;
+    }
+    this->built = true;
+    return true;
+}
+
+bool AssetManifest::isBuilt() {
+    return this->built;
+}
+
+const AssetManifest::Entry *AssetManifest::find(string filename) {
+    auto it = this->entries.find(filename);
+    if (it == this->entries.end()) return nullptr;
+    return &it->second;
+}
+
+bool AssetManifest::hasPath(string path) {
+    return this->paths.count(path) > 0;
+}
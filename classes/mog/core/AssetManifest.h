@@ -0,0 +1,48 @@
+#ifndef AssetManifest_h
+#define AssetManifest_h
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "mog/core/Density.h"
+
+using namespace std;
+
+namespace mog {
+
+    // maps the name of each asset to the file of the density nearest to the current one.
+    // built once at startup, so resolving an asset is a lookup and names that do not exist are never opened.
+    // it is read from the loader threads, and is not modified after it is built.
+    class AssetManifest {
+    public:
+        struct Entry {
+            string path;
+            int size = 0;
+            Density density = Density::x1_0;
+        };
+
+        static AssetManifest *getInstance();
+        // the current density first, then the higher ones from the nearest, then the lower ones from the nearest.
+        static vector<Density> getDensityOrder();
+
+        // lists the assets. returns false when the platform cannot list them, they are probed then.
+        bool build();
+        bool isBuilt();
+        // returns nullptr when there is no such asset
+        const Entry *find(string filename);
+        // whether the file exists, given with its density directory
+        bool hasPath(string path);
+
+    private:
+        static AssetManifest *instance;
+
+        unordered_map<string, Entry> entries;
+        unordered_set<string> paths;
+        bool built = false;
+
+        AssetManifest() {}
+    };
+}
+
+#endif /* AssetManifest_h */
@@ -0,0 +1,241 @@
+#include "mog/Constants.h"
+#include "mog/core/BatchBuilder.h"
+#include "mog/base/Entity.h"
+
+using namespace mog;
+
+BatchBuilder *BatchBuilder::instance;
+
+BatchBuilder *BatchBuilder::getInstance() {
+    if (BatchBuilder::instance == nullptr) {
+        BatchBuilder::instance = new BatchBuilder();
+    }
+    return BatchBuilder::instance;
+}
+
+BatchBuilder::BatchBuilder() {
+}
+
+// textures of the leaves are added to the atlas when one is given.
+void BatchBuilder::begin(const shared_ptr<TextureAtlas> &textureAtlas) {
+    this->textureAtlas = textureAtlas;
+    this->vertices.clear();
+    this->indices.clear();
+    this->ranges.clear();
+    this->textureRanges.clear();
+}
+
+// appends a leaf under the current matrix of the renderer. returns the index of its range, or -1 when it has no vertices.
+int BatchBuilder::add(Entity *entity, const Color &parentColor) {
+    int verticesNum = 0;
+    entity->getVerticesNum(&verticesNum);
+    if (verticesNum == 0) return -1;
+    
+    int start = (int)this->vertices.size();
+    int indicesStart = (int)this->indices.size();
+    int indicesNum = indicesStart;
+    entity->getIndiciesNum(&indicesNum);
+    
+    this->positions.resize(verticesNum * 2);
+    this->colors.assign(verticesNum * 4, 1.0f);
+    int idx = 0;
+    entity->bindVertices(this->positions.data(), &idx, true);
+    idx = 0;
+    entity->bindVertexColors(this->colors.data(), &idx, parentColor);
+    
+    // strips are joined with the last index of the previous leaf
+    this->indices.resize(indicesNum);
+    idx = indicesStart;
+    entity->bindIndices(this->indices.data(), &idx, start);
+    
+    this->vertices.resize(start + verticesNum);
+    for (int i = 0; i < verticesNum; i++) {
+        auto &v = this->vertices[start + i];
+        v.x = this->positions[i * 2 + 0];
+        v.y = this->positions[i * 2 + 1];
+        v.u = 0;
+        v.v = 0;
+        memcpy(&v.r, &this->colors[i * 4], sizeof(float) * 4);
+    }
+    
+    // only quads can be clipped to the trimmed area of their texture
+    if (this->textureAtlas) {
+        this->textureAtlas->addTexture(entity->getTexture(), verticesNum == 4);
+    }
+    
+    Range range;
+    range.entity = entity;
+    range.start = start;
+    range.verticesNum = verticesNum;
+    range.indicesStart = indicesStart;
+    range.indicesNum = indicesNum - indicesStart;
+    this->ranges.emplace_back(range);
+    return (int)this->ranges.size() - 1;
+}
+
+// texture coords depend on the packed cell, so they are bound once the atlas is created and uploaded.
+// leaves on different pages are split into runs that are drawn with their own texture.
+void BatchBuilder::mapTexCoords(const shared_ptr<TextureAtlas> &textureAtlas) {
+    this->textureAtlas = textureAtlas;
+    bool multiPage = (textureAtlas->getPageCount() > 1);
+    for (const auto &range : this->ranges) {
+        auto cell = textureAtlas->getCell(range.entity->getTexture());
+        if (!cell || !cell->placed) continue;
+        
+        this->positions.resize(range.verticesNum * 2);
+        this->texCoords.resize(range.verticesNum * 2);
+        for (int i = 0; i < range.verticesNum; i++) {
+            this->positions[i * 2 + 0] = this->vertices[range.start + i].x;
+            this->positions[i * 2 + 1] = this->vertices[range.start + i].y;
+        }
+        this->bindTexCoords(range.entity, cell, this->positions.data(), this->texCoords.data(), range.verticesNum);
+        for (int i = 0; i < range.verticesNum; i++) {
+            auto &v = this->vertices[range.start + i];
+            v.x = this->positions[i * 2 + 0];
+            v.y = this->positions[i * 2 + 1];
+            v.u = this->texCoords[i * 2 + 0];
+            v.v = this->texCoords[i * 2 + 1];
+        }
+        
+        if (!multiPage) continue;
+        auto texture = textureAtlas->getTexture(cell->page);
+        int textureId = texture ? texture->textureId : 0;
+        if (!this->textureRanges.empty() && this->textureRanges.back().textureId == textureId) continue;
+        if (!this->textureRanges.empty()) {
+            auto &last = this->textureRanges.back();
+            last.indicesNum = range.indicesStart - last.indicesStart;
+        }
+        // a run starts after the indices joining it to the previous leaf
+        Renderer::TextureRange textureRange;
+        textureRange.indicesStart = (range.start > 0) ? range.indicesStart + 2 : range.indicesStart;
+        textureRange.indicesNum = 0;
+        textureRange.textureId = textureId;
+        this->textureRanges.emplace_back(textureRange);
+    }
+    if (!this->textureRanges.empty()) {
+        auto &last = this->textureRanges.back();
+        last.indicesNum = (int)this->indices.size() - last.indicesStart;
+    }
+}
+
+// binds the texture coords of a leaf in the page of its cell.
+// a quad whose texture has been trimmed is clipped to the opaque area, so it never samples a neighbouring cell.
+void BatchBuilder::bindTexCoords(Entity *entity, const shared_ptr<TextureAtlasCell> &cell, float *positions, float *texCoords, int verticesNum) {
+    auto texture = this->textureAtlas->getTexture(cell->page);
+    int idx = 0;
+    if (!cell->rotated && !cell->isTrimmed()) {
+        float pageWidth = texture->width;
+        float pageHeight = texture->height;
+        entity->bindVertexTexCoords(texCoords, &idx, cell->x / pageWidth, cell->y / pageHeight, cell->width / pageWidth, cell->height / pageHeight);
+        return;
+    }
+    
+    // texture coords in the whole source texture
+    entity->bindVertexTexCoords(texCoords, &idx, 0, 0, 1.0f, 1.0f);
+    
+    if (cell->isTrimmed() && verticesNum == 4) {
+        float minS = texCoords[0], maxS = texCoords[0], minT = texCoords[1], maxT = texCoords[1];
+        for (int i = 1; i < 4; i++) {
+            minS = min(minS, texCoords[i * 2 + 0]);
+            maxS = max(maxS, texCoords[i * 2 + 0]);
+            minT = min(minT, texCoords[i * 2 + 1]);
+            maxT = max(maxT, texCoords[i * 2 + 1]);
+        }
+        float trimMinS = (float)cell->offsetX / cell->texture->width;
+        float trimMaxS = (float)(cell->offsetX + cell->getSourceWidth()) / cell->texture->width;
+        float trimMinT = (float)cell->offsetY / cell->texture->height;
+        float trimMaxT = (float)(cell->offsetY + cell->getSourceHeight()) / cell->texture->height;
+        // texture coords keep the same inset from the edges of the cell as untrimmed ones, at most half a texel
+        float insetS = min(0.001f * texture->width, 0.5f) / cell->texture->width;
+        float insetT = min(0.001f * texture->height, 0.5f) / cell->texture->height;
+        
+        // the corners of the quad, [left-top, right-top, left-bottom, right-bottom] in texture space
+        int corners[4] = {-1, -1, -1, -1};
+        for (int i = 0; i < 4; i++) {
+            int cx = (texCoords[i * 2 + 0] - minS < maxS - texCoords[i * 2 + 0]) ? 0 : 1;
+            int cy = (texCoords[i * 2 + 1] - minT < maxT - texCoords[i * 2 + 1]) ? 0 : 1;
+            corners[cy * 2 + cx] = i;
+        }
+        if (maxS > minS && maxT > minT && corners[0] >= 0 && corners[1] >= 0 && corners[2] >= 0 && corners[3] >= 0) {
+            float p[8];
+            for (int c = 0; c < 4; c++) {
+                p[c * 2 + 0] = positions[corners[c] * 2 + 0];
+                p[c * 2 + 1] = positions[corners[c] * 2 + 1];
+            }
+            for (int i = 0; i < 4; i++) {
+                float s = min(max(texCoords[i * 2 + 0], trimMinS), trimMaxS);
+                float t = min(max(texCoords[i * 2 + 1], trimMinT), trimMaxT);
+                float a = (s - minS) / (maxS - minS);
+                float b = (t - minT) / (maxT - minT);
+                for (int k = 0; k < 2; k++) {
+                    float top = p[0 * 2 + k] + (p[1 * 2 + k] - p[0 * 2 + k]) * a;
+                    float bottom = p[2 * 2 + k] + (p[3 * 2 + k] - p[2 * 2 + k]) * a;
+                    positions[i * 2 + k] = top + (bottom - top) * b;
+                }
+                texCoords[i * 2 + 0] = min(max(s, trimMinS + insetS), trimMaxS - insetS);
+                texCoords[i * 2 + 1] = min(max(t, trimMinT + insetT), trimMaxT - insetT);
+            }
+        }
+    }
+    
+    for (int i = 0; i < verticesNum; i++) {
+        float s = min(max(texCoords[i * 2 + 0], 0.0f), 1.0f);
+        float t = min(max(texCoords[i * 2 + 1], 0.0f), 1.0f);
+        this->textureAtlas->mapTexCoord(cell, s, t, &texCoords[i * 2 + 0], &texCoords[i * 2 + 1]);
+    }
+}
+
+// changed leaves are written into the vertices of the renderer, within the ranges of the last build.
+void BatchBuilder::beginUpdate(Renderer *renderer, const vector<Range> *ranges, const shared_ptr<TextureAtlas> &textureAtlas) {
+    this->renderer = renderer;
+    this->updateRanges = ranges;
+    this->textureAtlas = textureAtlas;
+}
+
+// rewrites a leaf under the current matrix of the renderer.
+// returns false when the leaf no longer fits its range and the whole batch has to be rebuilt.
+bool BatchBuilder::update(Entity *entity, int rangeIndex, const Color &parentColor, unsigned char flag) {
+    int verticesNum = 0;
+    entity->getVerticesNum(&verticesNum);
+    if (rangeIndex < 0 || rangeIndex >= this->updateRanges->size()) return verticesNum == 0;
+    const auto &range = (*this->updateRanges)[rangeIndex];
+    if (range.entity != entity || range.verticesNum != verticesNum) return false;
+    
+    // quads clipped to a trimmed texture need their positions and texture coords together
+    shared_ptr<TextureAtlasCell> cell = nullptr;
+    if (this->textureAtlas) {
+        cell = this->textureAtlas->getCell(entity->getTexture());
+        if (cell && !cell->placed) {
+            cell = nullptr;
+        }
+    }
+    bool clipped = (cell && cell->isTrimmed());
+    bool bindPositions = (flag & (RERENDER_VERTEX | RERENDER_TRANSFORM)) > 0;
+    // texture coords of some entities depend on their size
+    bool bindTexCoords = (flag & (RERENDER_VERTEX | RERENDER_TEX_COORDS)) > 0 && cell;
+    if (clipped && (bindPositions || bindTexCoords)) {
+        bindPositions = true;
+        bindTexCoords = true;
+    }
+    
+    int idx = 0;
+    if (bindPositions) {
+        this->positions.resize(verticesNum * 2);
+        entity->bindVertices(this->positions.data(), &idx, true);
+    }
+    if (bindTexCoords) {
+        this->texCoords.resize(verticesNum * 2);
+        this->bindTexCoords(entity, cell, this->positions.data(), this->texCoords.data(), verticesNum);
+        this->renderer->bindTextureVertexSub(this->texCoords.data(), verticesNum * 2, (int)(range.start * 2 * sizeof(float)));
+    }
+    if (bindPositions) {
+        this->renderer->bindVertexSub(this->positions.data(), verticesNum * 2, (int)(range.start * 2 * sizeof(float)));
+    }
+    if ((flag & RERENDER_COLOR) == RERENDER_COLOR) {
+        this->colors.assign(verticesNum * 4, 1.0f);
+        idx = 0;
+        entity->bindVertexColors(this->colors.data(), &idx, parentColor);
+        this->renderer->bindColorsVertexSub(this->colors.data(), verticesNum * 4, (int)(range.start * 4 * sizeof(float)));
+    }
+    return true;
+}
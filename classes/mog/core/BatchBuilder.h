@@ -0,0 +1,60 @@
+#ifndef BatchBuilder_h
+#define BatchBuilder_h
+
+#include <memory>
+#include <vector>
+#include "mog/core/RenderDevice.h"
+#include "mog/core/TextureAtlas.h"
+#include "mog/core/Renderer.h"
+
+using namespace std;
+
+namespace mog {
+    class Entity;
+    
+    // builds the mesh of a batching group in a single walk over its subtree.
+    // every leaf is visited once, texture coords are bound from the recorded leaves after the atlas is packed.
+    // buffers are shared and keep their capacity between rebuilds.
+    // a group keeps the ranges of its last build, so a changed leaf can be rewritten in place.
+    class BatchBuilder {
+    public:
+        // the vertices emitted for one leaf. entities are only valid until the next rebuild.
+        struct Range {
+            Entity *entity;
+            int start;
+            int verticesNum;
+            int indicesStart;
+            int indicesNum;
+        };
+        
+        static BatchBuilder *getInstance();
+        
+        vector<Vertex> vertices;
+        vector<short> indices;
+        vector<Range> ranges;
+        // runs of leaves on the same atlas page. empty while the atlas has a single page.
+        vector<Renderer::TextureRange> textureRanges;
+        
+        void begin(const shared_ptr<TextureAtlas> &textureAtlas);
+        int add(Entity *entity, const Color &parentColor);
+        void mapTexCoords(const shared_ptr<TextureAtlas> &textureAtlas);
+        
+        void beginUpdate(Renderer *renderer, const vector<Range> *ranges, const shared_ptr<TextureAtlas> &textureAtlas);
+        bool update(Entity *entity, int rangeIndex, const Color &parentColor, unsigned char flag);
+        
+    private:
+        static BatchBuilder *instance;
+        
+        shared_ptr<TextureAtlas> textureAtlas;
+        Renderer *renderer = nullptr;
+        const vector<Range> *updateRanges = nullptr;
+        vector<float> positions;
+        vector<float> texCoords;
+        vector<float> colors;
+        
+        BatchBuilder();
+        void bindTexCoords(Entity *entity, const shared_ptr<TextureAtlasCell> &cell, float *positions, float *texCoords, int verticesNum);
+    };
+}
+
+#endif /* BatchBuilder_h */
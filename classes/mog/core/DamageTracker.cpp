@@ -0,0 +1,64 @@
+#include "mog/core/DamageTracker.h"
+#include <algorithm>
+#include <string.h>
+
+using namespace mog;
+
+DamageTracker *DamageTracker::instance;
+
+DamageTracker *DamageTracker::getInstance() {
+    if (DamageTracker::instance == nullptr) {
+        DamageTracker::instance = new DamageTracker();
+    }
+    return DamageTracker::instance;
+}
+
+DamageTracker::DamageTracker() {
+}
+
+void DamageTracker::addDamage(const float *bounds) {
+    if (bounds[0] >= bounds[2] || bounds[1] >= bounds[3]) return;
+
+    if (!this->damaged) {
+        memcpy(this->bounds, bounds, sizeof(float) * 4);
+        this->damaged = true;
+    } else {
+        this->bounds[0] = min(this->bounds[0], bounds[0]);
+        this->bounds[1] = min(this->bounds[1], bounds[1]);
+        this->bounds[2] = max(this->bounds[2], bounds[2]);
+        this->bounds[3] = max(this->bounds[3], bounds[3]);
+    }
+}
+
+void DamageTracker::invalidate() {
+    this->damaged = true;
+    this->fullDamage = true;
+}
+
+bool DamageTracker::hasDamage() {
+    return this->damaged;
+}
+
+// the back buffer still holds the frame before the last one after a swap,
+// so the area damaged in the last drawn frame has to be redrawn again.
+bool DamageTracker::getRedrawRect(float *rect) {
+    if (this->fullDamage || this->lastFullDamage) return false;
+
+    rect[0] = min(this->bounds[0], this->lastBounds[0]);
+    rect[1] = min(this->bounds[1], this->lastBounds[1]);
+    rect[2] = max(this->bounds[2], this->lastBounds[2]);
+    rect[3] = max(this->bounds[3], this->lastBounds[3]);
+    return true;
+}
+
+void DamageTracker::commit() {
+    this->lastFullDamage = this->fullDamage;
+    memcpy(this->lastBounds, this->bounds, sizeof(float) * 4);
+    this->damaged = false;
+    this->fullDamage = false;
+}
+
+void DamageTracker::discard() {
+    if (this->fullDamage) return;
+    this->damaged = false;
+}
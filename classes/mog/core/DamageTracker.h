@@ -0,0 +1,36 @@
+#ifndef DamageTracker_h
+#define DamageTracker_h
+
+#include <memory>
+
+using namespace std;
+
+namespace mog {
+
+    // collects the screen areas changed since the last drawn frame.
+    // bounds are kept as [minX, minY, maxX, maxY] in display pixels.
+    class DamageTracker {
+    public:
+        static DamageTracker *getInstance();
+
+        void addDamage(const float *bounds);
+        void invalidate();
+        bool hasDamage();
+        bool getRedrawRect(float *rect);
+        void commit();
+        void discard();
+
+    private:
+        static DamageTracker *instance;
+
+        bool damaged = true;
+        bool fullDamage = true;
+        float bounds[4] = {0, 0, 0, 0};
+        bool lastFullDamage = true;
+        float lastBounds[4] = {0, 0, 0, 0};
+
+        DamageTracker();
+    };
+}
+
+#endif /* DamageTracker_h */
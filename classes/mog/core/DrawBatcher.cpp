@@ -0,0 +1,97 @@
+#include "mog/Constants.h"
+#include "mog/core/DrawBatcher.h"
+
+using namespace mog;
+
+DrawBatcher *DrawBatcher::instance;
+
+DrawBatcher *DrawBatcher::getInstance() {
+    if (DrawBatcher::instance == nullptr) {
+        DrawBatcher::instance = new DrawBatcher();
+    }
+    return DrawBatcher::instance;
+}
+
+DrawBatcher::DrawBatcher() {
+    this->renderer = make_shared<Renderer>();
+    this->vertices.reserve(4096);
+    this->indices.reserve(4096 * 2);
+}
+
+void DrawBatcher::add(const shared_ptr<Renderer> &renderer) {
+    int verticesNum = (int)renderer->vertices.size();
+    int indicesNum = (int)renderer->indices.size();
+    if (verticesNum == 0 || indicesNum == 0) return;
+    
+    int textureId = renderer->isEnableTexture() ? renderer->textureId : 0;
+    if (this->verticesNum > 0) {
+        if (textureId != this->textureId || renderer->premultipliedAlpha != this->renderer->premultipliedAlpha ||
+            this->verticesNum + verticesNum > MAX_BATCH_VERTICES) {
+            this->flush();
+        }
+    }
+    this->textureId = textureId;
+    this->renderer->premultipliedAlpha = renderer->premultipliedAlpha;
+    
+    // indices (strips are joined with degenerate triangles)
+    int start = this->verticesNum;
+    if (start > 0) {
+        this->indices.emplace_back(this->indices.back());
+        this->indices.emplace_back(renderer->indices[0] + start);
+    }
+    for (int i = 0; i < indicesNum; i++) {
+        this->indices.emplace_back(renderer->indices[i] + start);
+    }
+    
+    // vertices are copied with their texture coords, then positions are transformed in place
+    this->vertices.insert(this->vertices.end(), renderer->vertices.begin(), renderer->vertices.end());
+    Vertex *v = &this->vertices[start];
+    Renderer::transformVertices(renderer->matrix, v, v, verticesNum);
+    
+    // colors
+    const float *c = renderer->color;
+    if (renderer->isEnableColor()) {
+        for (int i = 0; i < verticesNum; i++) {
+            v[i].r *= c[0];
+            v[i].g *= c[1];
+            v[i].b *= c[2];
+            v[i].a *= c[3];
+        }
+    } else {
+        for (int i = 0; i < verticesNum; i++) {
+            memcpy(&v[i].r, c, sizeof(float) * 4);
+        }
+    }
+    // the vertex colors tint premultiplied texels
+    if (renderer->premultipliedAlpha) {
+        for (int i = 0; i < verticesNum; i++) {
+            v[i].r *= v[i].a;
+            v[i].g *= v[i].a;
+            v[i].b *= v[i].a;
+        }
+    }
+    
+    this->verticesNum += verticesNum;
+}
+
+void DrawBatcher::flush() {
+    if (this->verticesNum == 0) return;
+    
+    this->renderer->bindVertex(this->vertices, this->indices, this->textureId, true, true);
+    
+    this->renderer->pushMatrix();
+    this->renderer->pushColor();
+    this->renderer->setMatrix(Renderer::identityMatrix);
+    this->renderer->drawFrame();
+    this->renderer->popColor();
+    this->renderer->popMatrix();
+    
+    this->clear();
+}
+
+void DrawBatcher::clear() {
+    this->textureId = 0;
+    this->verticesNum = 0;
+    this->vertices.clear();
+    this->indices.clear();
+}
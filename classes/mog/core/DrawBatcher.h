@@ -0,0 +1,37 @@
+#ifndef DrawBatcher_h
+#define DrawBatcher_h
+
+#include <memory>
+#include <vector>
+#include "mog/core/Renderer.h"
+
+#define MAX_BATCH_VERTICES 65535
+
+using namespace std;
+
+namespace mog {
+    
+    // merges consecutive entities that share the same texture into one draw call.
+    // vertices are baked to world coordinates, so the batch is drawn with the identity matrix.
+    class DrawBatcher {
+    public:
+        static DrawBatcher *getInstance();
+        
+        void add(const shared_ptr<Renderer> &renderer);
+        void flush();
+        
+    private:
+        static DrawBatcher *instance;
+        
+        shared_ptr<Renderer> renderer;
+        int textureId = 0;
+        int verticesNum = 0;
+        vector<Vertex> vertices;
+        vector<short> indices;
+        
+        DrawBatcher();
+        void clear();
+    };
+}
+
+#endif /* DrawBatcher_h */
@@ -2,24 +2,23 @@
 #include <typeinfo>
 #include <unordered_map>
 #include <math.h>
-#include "mog/core/opengl.h"
 #include "mog/core/Engine.h"
-#include "mog/core/opengl.h"
 #include "mog/base/Scene.h"
 #include "mog/base/AppBase.h"
 #include "mog/core/Device.h"
 #include "mog/core/AudioPlayer.h"
 #include "mog/core/DataStore.h"
 #include "mog/core/NativePlugin.h"
+#include "mog/core/DrawBatcher.h"
+#include "mog/core/RenderDevice.h"
+#include "mog/core/ShaderRenderDevice.h"
+#include "mog/core/DamageTracker.h"
+#include "mog/core/TextureLoader.h"
+#include "mog/core/TextureCache.h"
+#include "mog/core/AssetManifest.h"
 
 using namespace mog;
 
-#if defined(MOG_OSX) || defined(MOG_QT)
-inline void glOrthof(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar) {
-    glOrtho(left, right, bottom, top, zNear, zFar);
-}
-#endif
-
 shared_ptr<Engine> Engine::create(const shared_ptr<AppBase> &app) {
     auto engine = shared_ptr<Engine>(new Engine());
     engine->app = app;
@@ -55,6 +54,8 @@ void Engine::startEngine() {
         this->stats = MogStats::create(statsEnable);
     }
     if (!this->initialized) {
+        // before any asset is loaded, the loader threads read the manifest without locking
+        AssetManifest::getInstance()->build();
         this->initParameters();
         this->app->onLoad();
         this->initialized = true;
@@ -85,16 +86,56 @@ void Engine::onDrawFrame(map<unsigned int, TouchInput> touches) {
     float delta = elapsed - this->lastElapsedSec;
     this->lastElapsedSec = elapsed;
 
+    this->stats->updateFrame(shared_from_this(), delta);
+    
+    RenderDevice::getInstance()->beginFrame();
     this->initScreen();
-    this->clearColor();
 
     this->stats->drawCallCount = 0;
+    this->stats->culledCount = 0;
+    this->stats->cacheHitCount = 0;
+    this->stats->cacheMissCount = 0;
+    this->stats->batchRebuildTime = 0;
+    this->stats->atlasUsedArea = 0;
+    this->stats->atlasPageArea = 0;
+    this->drawBegan = false;
+    this->frameDrawn = false;
+    unsigned long allocatedCount = MogStats::allocatedCount;
+    MogStats::countingAllocations = true;
+    
+    // textures decoded in the background become visible in this frame
+    TextureLoader::getInstance()->uploadTextures();
     
     if (this->app) {
         this->app->drawFrame(delta);
     }
+    // without a scene the app never begins drawing by itself
+    this->beginDraw(nullptr);
+    
+    if (this->frameDrawn) {
+        DrawBatcher::getInstance()->flush();
+    }
+    // a static scene should not allocate at all once it has been drawn
+    MogStats::countingAllocations = false;
+    MogStats::allocationCount = (int)(MogStats::allocatedCount - allocatedCount);
+#ifdef MOG_DEBUG
+    // warned once until a frame without damage allocates nothing again
+    if (this->damageTrackingEnable && !this->frameDrawn) {
+        if (MogStats::allocationCount > 0 && !this->allocationWarned) {
+            LOGW("Engine::onDrawFrame: %d allocations in a frame without damage", MogStats::allocationCount);
+        }
+        this->allocationWarned = (MogStats::allocationCount > 0);
+    }
+#endif
     
-    this->stats->drawFrame(shared_from_this(), delta);
+    if (this->frameDrawn) {
+        this->stats->drawFrame(shared_from_this(), delta);
+        this->endDraw();
+    }
+    RenderDevice::getInstance()->endFrame();
+    Texture2D::releaseUploadedData();
+    // textures released during the frame become evictable
+    TextureCache::getInstance()->trimToBudget();
     
     this->frameCount++;
     
@@ -104,9 +145,62 @@ void Engine::onDrawFrame(map<unsigned int, TouchInput> touches) {
     this->invokeOnUpdateFunc();
 }
 
+// called between updating and drawing the scene. returns false when nothing has changed
+// since the last drawn frame, otherwise clears the screen within the damaged area.
+bool Engine::beginDraw(const shared_ptr<Group> &rootGroup) {
+    if (this->drawBegan) return this->frameDrawn;
+    this->drawBegan = true;
+    
+    if (this->damageTrackingEnable) {
+        auto damageTracker = DamageTracker::getInstance();
+        if (rootGroup != this->lastRootGroup.lock()) {
+            damageTracker->invalidate();
+            this->lastRootGroup = rootGroup;
+        }
+        if (rootGroup) {
+            rootGroup->collectDamage(false);
+        }
+        if (!damageTracker->hasDamage()) return false;
+        
+        float rect[4];
+        if (damageTracker->getRedrawRect(rect)) {
+            int x = max(0, (int)floorf(rect[0]));
+            int y = max(0, (int)floorf(rect[1]));
+            int width = min((int)ceilf(rect[2]), (int)this->displaySize.width) - x;
+            int height = min((int)ceilf(rect[3]), (int)this->displaySize.height) - y;
+            if (width <= 0 || height <= 0) {
+                damageTracker->discard();
+                return false;
+            }
+            RenderDevice::getInstance()->setScissor(x, y, width, height);
+            Renderer::setCullRect(x, y, width, height);
+            this->scissorEnabled = true;
+        }
+    }
+    
+    this->clearColor();
+    this->frameDrawn = true;
+    return true;
+}
+
+bool Engine::isFrameDrawn() {
+    return this->frameDrawn;
+}
+
+void Engine::endDraw() {
+    if (this->scissorEnabled) {
+        RenderDevice::getInstance()->disableScissor();
+        Renderer::setCullRect(0, 0, this->displaySize.width, this->displaySize.height);
+        this->scissorEnabled = false;
+    }
+    DamageTracker::getInstance()->commit();
+}
+
 void Engine::onLowMemory() {
     if (!this->running) return;
     
+    // unreferenced textures are decoded again when they are used next
+    TextureCache::getInstance()->trim(0);
     if (this->app) {
         this->app->onLowMemory();
     }
@@ -114,26 +208,27 @@ void Engine::onLowMemory() {
 }
 
 void Engine::initParameters() {
-    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DITHER);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-    glDisableClientState(GL_COLOR_ARRAY);
+#ifndef MOG_SOFTWARE_RENDERER
+    if (this->shaderPipelineEnable) {
+        auto device = ShaderRenderDevice::create();
+        if (device->compilePrograms()) {
+            RenderDevice::setInstance(device);
+            this->displaySizeChanged = true;
+        } else {
+            LOGE("Engine::initParameters: failed to compile shaders, falling back to the fixed-function pipeline.");
+            this->shaderPipelineEnable = false;
+        }
+    }
+#endif
+    RenderDevice::getInstance()->initParameters();
 }
 
 void Engine::initScreen() {
     if (!this->displaySizeChanged) return;
     
-    glViewport(0, 0, this->displaySize.width, this->displaySize.height);
-    glMatrixMode(GL_PROJECTION);
-    glOrthof(0, this->displaySize.width, this->displaySize.height, 0, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    RenderDevice::getInstance()->initScreen(this->displaySize.width, this->displaySize.height);
+    Renderer::setCullRect(0, 0, this->displaySize.width, this->displaySize.height);
+    DamageTracker::getInstance()->invalidate();
     
     this->displaySizeChanged = false;
 }
@@ -203,17 +298,39 @@ Color Engine::getClearColor() {
 
 void Engine::setClearColor(const Color &color) {
     this->color = color;
+    DamageTracker::getInstance()->invalidate();
 }
 
 void Engine::clearColor() {
-    glClearColor(this->color.r, this->color.g, this->color.b, this->color.a);
-    glClear(GL_COLOR_BUFFER_BIT);
+    RenderDevice::getInstance()->clear(this->color);
 }
 
 void Engine::onKeyEvent(const KeyEvent &keyEvent) {
     
 }
 
+void Engine::setDamageTrackingEnable(bool enable) {
+    this->damageTrackingEnable = enable;
+    DamageTracker::getInstance()->invalidate();
+}
+
+bool Engine::isDamageTrackingEnable() {
+    return this->damageTrackingEnable;
+}
+
+// the pipeline is selected when the engine starts for the first time.
+void Engine::setShaderPipelineEnable(bool enable) {
+    if (this->initialized) {
+        LOGE("Engine::setShaderPipelineEnable: must be called before the engine starts.");
+        return;
+    }
+    this->shaderPipelineEnable = enable;
+}
+
+bool Engine::isShaderPipelineEnable() {
+    return this->shaderPipelineEnable;
+}
+
 void Engine::setStatsEnable(bool enable) {
     this->stats->setEnable(enable);
 }
@@ -26,6 +26,8 @@ namespace mog {
         void stopEngine();
         
         void onDrawFrame(map<unsigned int, TouchInput> touches);
+        bool beginDraw(const shared_ptr<Group> &rootGroup);
+        bool isFrameDrawn();
         void onLowMemory();
         void onKeyEvent(const KeyEvent &keyEvent);
 
@@ -55,6 +57,11 @@ namespace mog {
         long long getTimerElapsed();
         float getTimerElapsedSec();
         
+        void setDamageTrackingEnable(bool enable);
+        bool isDamageTrackingEnable();
+        void setShaderPipelineEnable(bool enable);
+        bool isShaderPipelineEnable();
+
         void setStatsEnable(bool enable);
         void setStatsAlignment(Alignment alignment);
         shared_ptr<MogStats> getStats();
@@ -98,6 +105,13 @@ namespace mog {
     private:
         bool initialized = false;
         bool displaySizeChanged = false;
+        bool damageTrackingEnable = false;
+        bool shaderPipelineEnable = false;
+        bool drawBegan = false;
+        bool frameDrawn = false;
+        bool scissorEnabled = false;
+        bool allocationWarned = false;
+        weak_ptr<Group> lastRootGroup;
         bool touchEnable = true;
         bool multiTouchEnable = true;
         vector<shared_ptr<Entity>> touchableEntities;
@@ -106,6 +120,7 @@ namespace mog {
         void initParameters();
         void setViewPortScale();
         void initScreen();
+        void endDraw();
         
         void fireTouchListeners(map<unsigned int, TouchInput> touches);
     };
@@ -3,9 +3,25 @@
 #include "mog/core/mog_functions.h"
 #include <fstream>
 #include <stdlib.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace mog;
 
+MappedFile::~MappedFile() {
+    if (this->isAsset) {
+        FileUtilsNative::unmapAsset(this->handle);
+    } else {
+#ifndef _WIN32
+        munmap((void *)this->data, this->length);
+#endif
+    }
+}
+
 bool FileUtils::existAsset(string filename) {
     return FileUtilsNative::existAsset(filename);
 }
@@ -18,6 +34,47 @@ bool FileUtils::readBytesAsset(string filename, unsigned char **data, int *len)
     return FileUtilsNative::readBytesAsset(filename, data, len);
 }
 
+bool FileUtils::listAssets(vector<pair<string, int>> *assets) {
+    return FileUtilsNative::listAssets(assets);
+}
+
+shared_ptr<MappedFile> FileUtils::mapAsset(string filename) {
+    const unsigned char *data = nullptr;
+    int len = 0;
+    void *handle = FileUtilsNative::mapAsset(filename, &data, &len);
+    if (handle == nullptr) return nullptr;
+    
+    auto mappedFile = make_shared<MappedFile>();
+    mappedFile->data = data;
+    mappedFile->length = len;
+    mappedFile->handle = handle;
+    mappedFile->isAsset = true;
+    return mappedFile;
+}
+
+shared_ptr<MappedFile> FileUtils::mapFile(string filepath) {
+#ifdef _WIN32
+    return nullptr;
+#else
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    // the mapping stays valid after the descriptor is closed
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+    
+    auto mappedFile = make_shared<MappedFile>();
+    mappedFile->data = (const unsigned char *)data;
+    mappedFile->length = (int)st.st_size;
+    return mappedFile;
+#endif
+}
+
 bool FileUtils::readFile(string filename, unsigned char **data, int *len, Directory dir) {
     string fileDir = "";
     if (dir == Directory::Documents) {
@@ -2,10 +2,29 @@
 #define FileUtils_h
 
 #include <string>
+#include <memory>
+#include <vector>
+#include <utility>
 
 using namespace std;
 
 namespace mog {
+    // a file mapped into memory. it is unmapped when released.
+    class MappedFile {
+    public:
+        friend class FileUtils;
+        
+        const unsigned char *data = nullptr;
+        int length = 0;
+        
+        ~MappedFile();
+        
+    private:
+        void *handle = nullptr;
+        bool isAsset = false;
+    };
+    
+    
     class FileUtils {
     public:
         enum class Directory {
@@ -16,6 +35,11 @@ namespace mog {
         static bool existAsset(string filename);
         static string readTextAsset(string filename);
         static bool readBytesAsset(string filename, unsigned char **data, int *len);
+        // the relative path and the size of every asset. returns false when the platform cannot list them.
+        static bool listAssets(vector<pair<string, int>> *assets);
+        // returns nullptr when the file cannot be mapped, e.g. a compressed resource. read it instead.
+        static shared_ptr<MappedFile> mapAsset(string filename);
+        static shared_ptr<MappedFile> mapFile(string filepath);
         
         static bool readFile(string filename, unsigned char **data, int *len, Directory dir = Directory::Documents);
         static bool writeFile(string filename, unsigned char *data, int len, Directory dir = Directory::Documents);
@@ -0,0 +1,356 @@
+#include "mog/Constants.h"
+#include "mog/core/GLRenderDevice.h"
+#include "mog/core/GLState.h"
+#include "mog/core/opengl.h"
+#include <stddef.h>
+#include <string.h>
+
+using namespace mog;
+
+#if defined(MOG_OSX) || defined(MOG_QT)
+inline void glOrthof(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar) {
+    glOrtho(left, right, bottom, top, zNear, zFar);
+}
+#endif
+
+void checkGLError(const char *label) {
+#ifndef MOG_QT
+    GLenum glError = glGetError();
+    if (glError != GL_NO_ERROR) {
+        LOGE("glError=%d : %s", glError, label);
+    }
+#endif
+}
+
+static GLenum toGLFormat(TextureType textureType) {
+    GLenum format = GL_RGBA;
+    switch (textureType){
+        case TextureType::RGBA:
+        case TextureType::RGBA4444:
+            format = GL_RGBA;
+            break;
+
+        case TextureType::RGB:
+        case TextureType::RGB565:
+            format = GL_RGB;
+            break;
+
+        case TextureType::A8:
+            format = GL_ALPHA;
+            break;
+
+        case TextureType::LA88:
+            format = GL_LUMINANCE_ALPHA;
+            break;
+    }
+    return format;
+}
+
+// desktop GL stores unsized formats in a precision of its choice, usually 8 bits per channel,
+// so the types are requested with sized formats there. GLES only takes unsized formats.
+static GLint toGLInternalFormat(TextureType textureType) {
+#if defined(MOG_OSX) || defined(MOG_QT)
+    switch (textureType){
+        case TextureType::RGBA:
+            return GL_RGBA8;
+
+        case TextureType::RGB:
+            return GL_RGB8;
+
+        case TextureType::RGBA4444:
+            return GL_RGBA4;
+
+        case TextureType::RGB565:
+            return GL_RGB5;
+
+        case TextureType::A8:
+            return GL_ALPHA8;
+
+        case TextureType::LA88:
+            return GL_LUMINANCE8_ALPHA8;
+    }
+#endif
+    return toGLFormat(textureType);
+}
+
+static GLenum toGLType(TextureType textureType) {
+    switch (textureType){
+        case TextureType::RGBA4444:
+            return GL_UNSIGNED_SHORT_4_4_4_4;
+
+        case TextureType::RGB565:
+            return GL_UNSIGNED_SHORT_5_6_5;
+
+        default:
+            return GL_UNSIGNED_BYTE;
+    }
+}
+
+void GLRenderDevice::initParameters() {
+    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
+    GLState::invalidate();
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DITHER);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_CULL_FACE);
+    GLState::setClientStates(CLIENT_STATE_VERTEX_ARRAY | CLIENT_STATE_TEXTURE_COORD_ARRAY);
+}
+
+void GLRenderDevice::initScreen(int width, int height) {
+    this->screenWidth = width;
+    this->screenHeight = height;
+    if (this->renderTargetStack.size() == 0) {
+        this->setViewport(width, height);
+    }
+}
+
+void GLRenderDevice::setViewport(int width, int height) {
+    static const GLfloat identity[16] = {
+        1, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 1, 0,
+        0, 0, 0, 1
+    };
+    glViewport(0, 0, width, height);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrthof(0, width, height, 0, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    GLState::loadMatrixf(identity);
+}
+
+void GLRenderDevice::beginFrame() {
+    GLState::skippedCallCount = 0;
+}
+
+void GLRenderDevice::clear(const Color &color) {
+    glClearColor(color.r, color.g, color.b, color.a);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void GLRenderDevice::setScissor(int x, int y, int width, int height) {
+    // the scissor box starts at the bottom left corner
+    this->enableScissor = true;
+    GLState::enable(GL_SCISSOR_TEST);
+    glScissor(x, this->screenHeight - y - height, width, height);
+}
+
+void GLRenderDevice::disableScissor() {
+    this->enableScissor = false;
+    GLState::disable(GL_SCISSOR_TEST);
+}
+
+void GLRenderDevice::createBuffers(int num, unsigned int *buffers) {
+    glGenBuffers(num, buffers);
+}
+
+void GLRenderDevice::deleteBuffers(int num, const unsigned int *buffers) {
+    GLState::deleteBuffers(num, buffers);
+}
+
+void GLRenderDevice::uploadVertices(unsigned int buffer, const Vertex *vertices, int verticesNum, bool dynamicDraw) {
+    GLState::bindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * verticesNum, vertices, (dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
+    checkGLError("uploadVertices");
+}
+
+void GLRenderDevice::uploadVerticesSub(unsigned int buffer, int offset, const Vertex *vertices, int verticesNum) {
+    GLState::bindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(Vertex) * offset, sizeof(Vertex) * verticesNum, vertices);
+    checkGLError("uploadVerticesSub");
+}
+
+void GLRenderDevice::uploadIndices(unsigned int buffer, const short *indices, int indicesNum, bool dynamicDraw) {
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(short) * indicesNum, indices, (dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
+    checkGLError("uploadIndices");
+}
+
+void GLRenderDevice::uploadIndicesSub(unsigned int buffer, int offset, const short *indices, int indicesNum) {
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(short) * offset, sizeof(short) * indicesNum, indices);
+    checkGLError("uploadIndicesSub");
+}
+
+unsigned int GLRenderDevice::createTexture() {
+    GLuint textureId = 0;
+    glGenTextures(1, &textureId);
+    return textureId;
+}
+
+void GLRenderDevice::deleteTexture(unsigned int textureId) {
+    GLState::deleteTextures(1, &textureId);
+}
+
+void GLRenderDevice::uploadTexture(unsigned int textureId, TextureType textureType, int width, int height, const unsigned char *data) {
+    GLState::bindTexture(textureId);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    GLenum format = toGLFormat(textureType);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, toGLInternalFormat(textureType), width, height, 0, format, toGLType(textureType), data);
+    checkGLError("uploadTexture");
+}
+
+void GLRenderDevice::uploadTextureSub(unsigned int textureId, TextureType textureType, int x, int y, int width, int height, const unsigned char *data) {
+    GLState::bindTexture(textureId);
+
+    GLenum format = toGLFormat(textureType);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, toGLType(textureType), data);
+    checkGLError("uploadTextureSub");
+}
+
+void GLRenderDevice::uploadTextureLevel(unsigned int textureId, TextureType textureType, int level, int width, int height, const unsigned char *data) {
+    GLState::bindTexture(textureId);
+    
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLenum format = toGLFormat(textureType);
+    
+    glTexImage2D(GL_TEXTURE_2D, level, toGLInternalFormat(textureType), width, height, 0, format, toGLType(textureType), data);
+    checkGLError("uploadTextureLevel");
+}
+
+// the storage of unsized formats is up to the driver, so no savings are reported for them
+int GLRenderDevice::getTextureBytesPerPixel(TextureType textureType) {
+#if defined(MOG_OSX) || defined(MOG_QT)
+    return Texture2D::getBytesPerPixel(textureType);
+#else
+    return Texture2D::getBytesPerPixel(TextureType::RGBA);
+#endif
+}
+
+// levels above maxLevel are never sampled, so the texture is complete without them
+void GLRenderDevice::setTextureMaxLevel(unsigned int textureId, int maxLevel) {
+    GLState::bindTexture(textureId);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, maxLevel > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    checkGLError("setTextureMaxLevel");
+}
+
+// provided with the framebuffer object extension. without it the levels are downsampled on the cpu.
+bool GLRenderDevice::generateMipmap(unsigned int textureId) {
+    if (!this->mipmapSupportChecked) {
+        const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+        this->mipmapSupported = extensions != nullptr &&
+            (strstr(extensions, "GL_EXT_framebuffer_object") != nullptr || strstr(extensions, "GL_ARB_framebuffer_object") != nullptr);
+        this->mipmapSupportChecked = true;
+    }
+    if (!this->mipmapSupported) return false;
+    
+    GLState::bindTexture(textureId);
+    
+    glGenerateMipmapEXT(GL_TEXTURE_2D);
+    checkGLError("generateMipmap");
+    return true;
+}
+
+unsigned int GLRenderDevice::createRenderTarget(unsigned int textureId) {
+    GLuint renderTarget = 0;
+    glGenFramebuffersEXT(1, &renderTarget);
+    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, renderTarget);
+    glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, textureId, 0);
+    GLenum status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
+    
+    GLuint current = (this->renderTargetStack.size() > 0) ? this->renderTargetStack.back().renderTarget : 0;
+    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, current);
+    
+    if (status != GL_FRAMEBUFFER_COMPLETE_EXT) {
+        LOGE("createRenderTarget: framebuffer is not complete. status=%d", status);
+        glDeleteFramebuffersEXT(1, &renderTarget);
+        return 0;
+    }
+    return renderTarget;
+}
+
+void GLRenderDevice::deleteRenderTarget(unsigned int renderTarget) {
+    glDeleteFramebuffersEXT(1, &renderTarget);
+}
+
+void GLRenderDevice::beginRenderTarget(unsigned int renderTarget, int width, int height) {
+    RenderTargetState state;
+    state.renderTarget = renderTarget;
+    state.width = width;
+    state.height = height;
+    this->renderTargetStack.emplace_back(state);
+    
+    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, renderTarget);
+    this->setViewport(width, height);
+    // the scissor box belongs to the screen
+    GLState::disable(GL_SCISSOR_TEST);
+}
+
+void GLRenderDevice::endRenderTarget() {
+    if (this->renderTargetStack.size() == 0) return;
+    this->renderTargetStack.pop_back();
+    
+    if (this->renderTargetStack.size() > 0) {
+        const auto &state = this->renderTargetStack.back();
+        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, state.renderTarget);
+        this->setViewport(state.width, state.height);
+    } else {
+        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+        this->setViewport(this->screenWidth, this->screenHeight);
+        if (this->enableScissor) {
+            GLState::enable(GL_SCISSOR_TEST);
+        }
+    }
+}
+
+// offscreen textures hold colors already multiplied by alpha. while a render target is bound, the alpha is
+// accumulated with "over" instead of being multiplied by itself, so the texture it fills is premultiplied too.
+void GLRenderDevice::applyBlendFunc(bool premultipliedAlpha) {
+    GLenum src = premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+    if (this->renderTargetStack.size() > 0) {
+        GLState::blendFuncSeparate(src, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+        GLState::blendFunc(src, GL_ONE_MINUS_SRC_ALPHA);
+    }
+}
+
+void GLRenderDevice::draw(const DrawCommand &command) {
+    // matrix and color
+    GLState::loadMatrixf(command.matrix);
+    if (!command.enableColor) {
+        GLState::color4f(command.color[0], command.color[1], command.color[2], command.color[3]);
+    }
+    this->applyBlendFunc(command.premultipliedAlpha);
+
+    // bind interleaved vertices
+    GLState::bindBuffer(GL_ARRAY_BUFFER, command.vertexBuffer);
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, x));
+
+    // bind indices
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, command.indexBuffer);
+
+    unsigned char clientStates = CLIENT_STATE_VERTEX_ARRAY;
+    GLState::setEnabled(GL_TEXTURE_2D, command.enableTexture);
+    if (command.enableTexture) {
+        clientStates |= CLIENT_STATE_TEXTURE_COORD_ARRAY;
+        GLState::bindTexture(command.textureId);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, u));
+    }
+    if (command.enableColor) {
+        clientStates |= CLIENT_STATE_COLOR_ARRAY;
+        glColorPointer(4, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, r));
+    }
+    GLState::setClientStates(clientStates);
+
+    // draw
+    glDrawElements(GL_TRIANGLE_STRIP, command.indicesNum, GL_UNSIGNED_SHORT, (void *)(sizeof(short) * command.indicesOffset));
+
+    // the current color is undefined after drawing with a color array
+    if (command.enableColor) {
+        GLState::invalidateColor();
+    }
+
+    checkGLError("draw");
+}
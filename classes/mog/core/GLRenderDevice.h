@@ -0,0 +1,60 @@
+#ifndef GLRenderDevice_h
+#define GLRenderDevice_h
+
+#include <vector>
+#include "mog/core/RenderDevice.h"
+
+namespace mog {
+
+    class GLRenderDevice : public RenderDevice {
+    public:
+        virtual void initParameters() override;
+        virtual void initScreen(int width, int height) override;
+        virtual void beginFrame() override;
+        virtual void clear(const Color &color) override;
+        virtual void setScissor(int x, int y, int width, int height) override;
+        virtual void disableScissor() override;
+
+        virtual void createBuffers(int num, unsigned int *buffers) override;
+        virtual void deleteBuffers(int num, const unsigned int *buffers) override;
+        virtual void uploadVertices(unsigned int buffer, const Vertex *vertices, int verticesNum, bool dynamicDraw) override;
+        virtual void uploadVerticesSub(unsigned int buffer, int offset, const Vertex *vertices, int verticesNum) override;
+        virtual void uploadIndices(unsigned int buffer, const short *indices, int indicesNum, bool dynamicDraw) override;
+        virtual void uploadIndicesSub(unsigned int buffer, int offset, const short *indices, int indicesNum) override;
+
+        virtual unsigned int createTexture() override;
+        virtual void deleteTexture(unsigned int textureId) override;
+        virtual void uploadTexture(unsigned int textureId, TextureType textureType, int width, int height, const unsigned char *data) override;
+        virtual void uploadTextureSub(unsigned int textureId, TextureType textureType, int x, int y, int width, int height, const unsigned char *data) override;
+        virtual void uploadTextureLevel(unsigned int textureId, TextureType textureType, int level, int width, int height, const unsigned char *data) override;
+        virtual void setTextureMaxLevel(unsigned int textureId, int maxLevel) override;
+        virtual int getTextureBytesPerPixel(TextureType textureType) override;
+        virtual bool generateMipmap(unsigned int textureId) override;
+
+        virtual unsigned int createRenderTarget(unsigned int textureId) override;
+        virtual void deleteRenderTarget(unsigned int renderTarget) override;
+        virtual void beginRenderTarget(unsigned int renderTarget, int width, int height) override;
+        virtual void endRenderTarget() override;
+
+        virtual void draw(const DrawCommand &command) override;
+
+    protected:
+        struct RenderTargetState {
+            unsigned int renderTarget;
+            int width;
+            int height;
+        };
+
+        int screenWidth = 0;
+        int screenHeight = 0;
+        bool enableScissor = false;
+        bool mipmapSupportChecked = false;
+        bool mipmapSupported = false;
+        vector<RenderTargetState> renderTargetStack;
+
+        virtual void setViewport(int width, int height);
+        void applyBlendFunc(bool premultipliedAlpha);
+    };
+}
+
+#endif /* GLRenderDevice_h */
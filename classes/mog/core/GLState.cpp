@@ -0,0 +1,227 @@
+#include "mog/core/GLState.h"
+#include <string.h>
+
+using namespace mog;
+
+#define UNKNOWN_ID ((GLuint)-1)
+
+int GLState::skippedCallCount = 0;
+bool GLState::valid = false;
+bool GLState::validMatrix = false;
+unsigned int GLState::enabledCaps = 0;
+unsigned int GLState::knownCaps = 0;
+unsigned char GLState::clientStates = 0;
+GLuint GLState::textureId = UNKNOWN_ID;
+GLuint GLState::arrayBuffer = UNKNOWN_ID;
+GLuint GLState::elementArrayBuffer = UNKNOWN_ID;
+GLenum GLState::blendSrc = 0;
+GLenum GLState::blendDst = 0;
+GLenum GLState::blendSrcAlpha = 0;
+GLenum GLState::blendDstAlpha = 0;
+GLfloat GLState::color[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+GLfloat GLState::matrix[16];
+
+void GLState::invalidate() {
+    GLState::valid = false;
+    GLState::validMatrix = false;
+    GLState::enabledCaps = 0;
+    GLState::knownCaps = 0;
+    GLState::clientStates = 0;
+    GLState::textureId = UNKNOWN_ID;
+    GLState::arrayBuffer = UNKNOWN_ID;
+    GLState::elementArrayBuffer = UNKNOWN_ID;
+    GLState::blendSrc = 0;
+    GLState::blendDst = 0;
+    GLState::blendSrcAlpha = 0;
+    GLState::blendDstAlpha = 0;
+    GLState::invalidateColor();
+}
+
+void GLState::invalidateColor() {
+    for (int i = 0; i < 4; i++) {
+        GLState::color[i] = -1.0f;
+    }
+}
+
+int GLState::capIndex(GLenum cap) {
+    switch (cap) {
+        case GL_TEXTURE_2D:
+            return 0;
+        case GL_BLEND:
+            return 1;
+        case GL_DEPTH_TEST:
+            return 2;
+        case GL_LIGHTING:
+            return 3;
+        case GL_DITHER:
+            return 4;
+        case GL_CULL_FACE:
+            return 5;
+        case GL_SCISSOR_TEST:
+            return 6;
+        default:
+            return -1;
+    }
+}
+
+void GLState::enable(GLenum cap) {
+    GLState::setEnabled(cap, true);
+}
+
+void GLState::disable(GLenum cap) {
+    GLState::setEnabled(cap, false);
+}
+
+void GLState::setEnabled(GLenum cap, bool enabled) {
+    int idx = GLState::capIndex(cap);
+    if (idx < 0) {
+        if (enabled) {
+            glEnable(cap);
+        } else {
+            glDisable(cap);
+        }
+        return;
+    }
+    unsigned int bit = (1 << idx);
+    if ((GLState::knownCaps & bit) > 0 && ((GLState::enabledCaps & bit) > 0) == enabled) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    if (enabled) {
+        glEnable(cap);
+        GLState::enabledCaps |= bit;
+    } else {
+        glDisable(cap);
+        GLState::enabledCaps &= ~bit;
+    }
+    GLState::knownCaps |= bit;
+}
+
+unsigned char GLState::toClientStateBit(GLenum array) {
+    switch (array) {
+        case GL_VERTEX_ARRAY:
+            return CLIENT_STATE_VERTEX_ARRAY;
+        case GL_TEXTURE_COORD_ARRAY:
+            return CLIENT_STATE_TEXTURE_COORD_ARRAY;
+        case GL_COLOR_ARRAY:
+            return CLIENT_STATE_COLOR_ARRAY;
+        default:
+            return 0;
+    }
+}
+
+void GLState::setClientStates(unsigned char mask) {
+    const GLenum arrays[3] = {GL_VERTEX_ARRAY, GL_TEXTURE_COORD_ARRAY, GL_COLOR_ARRAY};
+    for (int i = 0; i < 3; i++) {
+        unsigned char bit = (1 << i);
+        if (GLState::valid && (GLState::clientStates & bit) == (mask & bit)) {
+            GLState::skippedCallCount++;
+            continue;
+        }
+        if ((mask & bit) > 0) {
+            glEnableClientState(arrays[i]);
+        } else {
+            glDisableClientState(arrays[i]);
+        }
+    }
+    GLState::clientStates = mask;
+    GLState::valid = true;
+}
+
+void GLState::enableClientState(GLenum array) {
+    unsigned char mask = GLState::valid ? GLState::clientStates : 0;
+    GLState::setClientStates(mask | GLState::toClientStateBit(array));
+}
+
+void GLState::disableClientState(GLenum array) {
+    unsigned char mask = GLState::valid ? GLState::clientStates : 0;
+    GLState::setClientStates(mask & ~GLState::toClientStateBit(array));
+}
+
+void GLState::bindTexture(GLuint textureId) {
+    if (GLState::textureId == textureId) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    GLState::textureId = textureId;
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint *current = (target == GL_ELEMENT_ARRAY_BUFFER) ? &GLState::elementArrayBuffer : &GLState::arrayBuffer;
+    if (*current == buffer) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glBindBuffer(target, buffer);
+    *current = buffer;
+}
+
+void GLState::deleteTextures(GLsizei n, const GLuint *textures) {
+    for (int i = 0; i < n; i++) {
+        if (textures[i] == GLState::textureId) {
+            GLState::textureId = UNKNOWN_ID;
+        }
+    }
+    glDeleteTextures(n, textures);
+}
+
+void GLState::deleteBuffers(GLsizei n, const GLuint *buffers) {
+    for (int i = 0; i < n; i++) {
+        if (buffers[i] == GLState::arrayBuffer) {
+            GLState::arrayBuffer = UNKNOWN_ID;
+        }
+        if (buffers[i] == GLState::elementArrayBuffer) {
+            GLState::elementArrayBuffer = UNKNOWN_ID;
+        }
+    }
+    glDeleteBuffers(n, buffers);
+}
+
+void GLState::blendFunc(GLenum sfactor, GLenum dfactor) {
+    if (GLState::blendSrc == sfactor && GLState::blendDst == dfactor &&
+        GLState::blendSrcAlpha == sfactor && GLState::blendDstAlpha == dfactor) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glBlendFunc(sfactor, dfactor);
+    GLState::blendSrc = sfactor;
+    GLState::blendDst = dfactor;
+    GLState::blendSrcAlpha = sfactor;
+    GLState::blendDstAlpha = dfactor;
+}
+
+void GLState::blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+    if (GLState::blendSrc == srcRGB && GLState::blendDst == dstRGB &&
+        GLState::blendSrcAlpha == srcAlpha && GLState::blendDstAlpha == dstAlpha) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    GLState::blendSrc = srcRGB;
+    GLState::blendDst = dstRGB;
+    GLState::blendSrcAlpha = srcAlpha;
+    GLState::blendDstAlpha = dstAlpha;
+}
+
+void GLState::color4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+    if (GLState::color[0] == r && GLState::color[1] == g && GLState::color[2] == b && GLState::color[3] == a) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glColor4f(r, g, b, a);
+    GLState::color[0] = r;
+    GLState::color[1] = g;
+    GLState::color[2] = b;
+    GLState::color[3] = a;
+}
+
+void GLState::loadMatrixf(const GLfloat *matrix) {
+    if (GLState::validMatrix && memcmp(GLState::matrix, matrix, sizeof(GLfloat) * 16) == 0) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glLoadMatrixf(matrix);
+    memcpy(GLState::matrix, matrix, sizeof(GLfloat) * 16);
+    GLState::validMatrix = true;
+}
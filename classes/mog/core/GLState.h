@@ -0,0 +1,58 @@
+#ifndef GLState_h
+#define GLState_h
+
+#include "mog/core/opengl.h"
+
+#define CLIENT_STATE_VERTEX_ARRAY 1
+#define CLIENT_STATE_TEXTURE_COORD_ARRAY 2
+#define CLIENT_STATE_COLOR_ARRAY 4
+
+namespace mog {
+
+    // tracks the current GL state and only forwards real changes to the driver.
+    class GLState {
+    public:
+        static int skippedCallCount;
+
+        static void invalidate();
+        static void invalidateColor();
+
+        static void enable(GLenum cap);
+        static void disable(GLenum cap);
+        static void setEnabled(GLenum cap, bool enabled);
+        static void setClientStates(unsigned char mask);
+        static void enableClientState(GLenum array);
+        static void disableClientState(GLenum array);
+
+        static void bindTexture(GLuint textureId);
+        static void bindBuffer(GLenum target, GLuint buffer);
+        static void deleteTextures(GLsizei n, const GLuint *textures);
+        static void deleteBuffers(GLsizei n, const GLuint *buffers);
+
+        static void blendFunc(GLenum sfactor, GLenum dfactor);
+        static void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+        static void color4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+        static void loadMatrixf(const GLfloat *matrix);
+
+    private:
+        static int capIndex(GLenum cap);
+        static unsigned char toClientStateBit(GLenum array);
+
+        static bool valid;
+        static bool validMatrix;
+        static unsigned int enabledCaps;
+        static unsigned int knownCaps;
+        static unsigned char clientStates;
+        static GLuint textureId;
+        static GLuint arrayBuffer;
+        static GLuint elementArrayBuffer;
+        static GLenum blendSrc;
+        static GLenum blendDst;
+        static GLenum blendSrcAlpha;
+        static GLenum blendDstAlpha;
+        static GLfloat color[4];
+        static GLfloat matrix[16];
+    };
+}
+
+#endif /* GLState_h */
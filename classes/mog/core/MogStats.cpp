@@ -1,7 +1,10 @@
 #include "mog/core/MogStats.h"
 #include "mog/core/Engine.h"
+#include "mog/core/GLState.h"
+#include "mog/core/DamageTracker.h"
 #include "mog/base/AppBase.h"
 #include <math.h>
+#include <new>
 
 using namespace mog;
 
@@ -9,11 +12,60 @@ using namespace mog;
 #define DELTA 1
 #define DRAW_CALL 2
 #define INSTANTS 3
+#define GL_SKIPPED 4
+#define CULLED 5
+#define CACHE_HIT 6
+#define CACHE_MISS 7
+#define ALLOCATION 8
+#define BATCH_TIME 9
+#define ATLAS 10
+#define TEXTURE_MEMORY 11
+#define TEXTURE_SAVED 12
+#define TEXTURE_CACHE_HIT 13
+#define TEXTURE_CACHE_MISS 14
+#define TEXTURE_CACHE_EVICT 15
 #define ALPHA 150
 #define INTERVAL 0.2f
 
 int MogStats::drawCallCount = 0;
 int MogStats::instanceCount = 0;
+int MogStats::culledCount = 0;
+int MogStats::cacheHitCount = 0;
+int MogStats::cacheMissCount = 0;
+float MogStats::batchRebuildTime = 0;
+long MogStats::atlasUsedArea = 0;
+long MogStats::atlasPageArea = 0;
+long MogStats::textureBytes = 0;
+long MogStats::textureRGBABytes = 0;
+int MogStats::textureCacheHitCount = 0;
+int MogStats::textureCacheMissCount = 0;
+int MogStats::textureCacheEvictCount = 0;
+int MogStats::allocationCount = 0;
+unsigned long MogStats::allocatedCount = 0;
+thread_local bool MogStats::countingAllocations = false;
+
+#ifdef MOG_DEBUG
+void *operator new(size_t size) {
+    if (MogStats::countingAllocations) {
+        MogStats::allocatedCount++;
+    }
+    void *p = malloc(size > 0 ? size : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+#endif
 
 shared_ptr<MogStats> MogStats::create(bool enable) {
     auto stats = shared_ptr<MogStats>(new MogStats());
@@ -22,7 +74,8 @@ shared_ptr<MogStats> MogStats::create(bool enable) {
     return stats;
 }
 
-void MogStats::drawFrame(const shared_ptr<Engine> &engine, float delta) {
+// values are taken from the counters of the last frame, before they are reset.
+void MogStats::updateFrame(const shared_ptr<Engine> &engine, float delta) {
     if (!this->enable) return;
     
     this->screenScale = engine->getScreenScale();
@@ -31,7 +84,9 @@ void MogStats::drawFrame(const shared_ptr<Engine> &engine, float delta) {
         this->init();
     }
     if (this->dirtyPosition) {
+        this->addDamage();
         this->updatePosition();
+        this->addDamage();
     }
 
     this->tmpDelta += delta;
@@ -39,16 +94,36 @@ void MogStats::drawFrame(const shared_ptr<Engine> &engine, float delta) {
         this->updateValues(delta);
         this->texture->bindTexture();
         this->tmpDelta = 0;
+        this->addDamage();
     }
+}
+
+void MogStats::drawFrame(const shared_ptr<Engine> &engine, float delta) {
+    if (!this->enable) return;
+    
     this->renderer->drawFrame(this->transform, this->screenScale);
 }
 
+void MogStats::addDamage() {
+    if (!this->initialized) return;
+    
+    float bounds[4];
+    this->renderer->pushMatrix();
+    this->renderer->applyTransform(this->transform, this->screenScale, false);
+    if (this->renderer->getWorldBounds(bounds)) {
+        DamageTracker::getInstance()->addDamage(bounds);
+    }
+    this->renderer->popMatrix();
+}
+
 bool MogStats::isEnabled() {
     return this->enable;
 }
 
 void MogStats::setEnable(bool enable) {
+    if (this->enable == enable) return;
     this->enable = enable;
+    DamageTracker::getInstance()->invalidate();
 }
 
 void MogStats::setAlignment(Alignment alignment) {
@@ -149,11 +224,49 @@ void MogStats::init() {
     auto drawCall = this->createLabelTexture("0");
     auto instantsLabel = this->createLabelTexture("INSTANTS  :");
     auto instants = this->createLabelTexture("0");
+    auto glSkippedLabel = this->createLabelTexture("GL SKIPPED:");
+    auto glSkipped = this->createLabelTexture("0");
+    auto culledLabel = this->createLabelTexture("CULLED    :");
+    auto culled = this->createLabelTexture("0");
+    auto cacheHitLabel = this->createLabelTexture("CACHE HIT :");
+    auto cacheHit = this->createLabelTexture("0");
+    auto cacheMissLabel = this->createLabelTexture("CACHE MISS:");
+    auto cacheMiss = this->createLabelTexture("0");
+    auto allocationLabel = this->createLabelTexture("ALLOCS    :");
+    auto allocation = this->createLabelTexture("0");
+    auto batchTimeLabel = this->createLabelTexture("BATCH MS  :");
+    auto batchTime = this->createLabelTexture("0.00");
+    auto atlasLabel = this->createLabelTexture("ATLAS %   :");
+    auto atlas = this->createLabelTexture("0.0");
+    auto textureMemoryLabel = this->createLabelTexture("TEX MB    :");
+    auto textureMemory = this->createLabelTexture("0.0");
+    auto textureSavedLabel = this->createLabelTexture("TEX SAVED :");
+    auto textureSaved = this->createLabelTexture("0.0");
+    auto textureCacheHitLabel = this->createLabelTexture("TEX HIT   :");
+    auto textureCacheHit = this->createLabelTexture("0");
+    auto textureCacheMissLabel = this->createLabelTexture("TEX MISS  :");
+    auto textureCacheMiss = this->createLabelTexture("0");
+    auto textureCacheEvictLabel = this->createLabelTexture("TEX EVICT :");
+    auto textureCacheEvict = this->createLabelTexture("0");
 
     this->width = fps->width + separator->width + delta->width + xMargin * 2 + padding * 2;
+    // leave room for counters up to 8 digits
+    this->width = max(this->width, glSkippedLabel->width + xMargin + this->numberTexture2ds[0]->width * 8 + padding * 2);
     this->height = max(fps->height, delta->height) +
         max(drawCallLabel->height, drawCall->height) +
-        max(instantsLabel->height, instants->height) + padding * 2;
+        max(instantsLabel->height, instants->height) +
+        max(glSkippedLabel->height, glSkipped->height) +
+        max(culledLabel->height, culled->height) +
+        max(cacheHitLabel->height, cacheHit->height) +
+        max(cacheMissLabel->height, cacheMiss->height) +
+        max(allocationLabel->height, allocation->height) +
+        max(batchTimeLabel->height, batchTime->height) +
+        max(atlasLabel->height, atlas->height) +
+        max(textureMemoryLabel->height, textureMemory->height) +
+        max(textureSavedLabel->height, textureSaved->height) +
+        max(textureCacheHitLabel->height, textureCacheHit->height) +
+        max(textureCacheMissLabel->height, textureCacheMiss->height) +
+        max(textureCacheEvictLabel->height, textureCacheEvict->height) + padding * 2;
     this->data = (unsigned char *)calloc(this->width * this->height * 4, sizeof(unsigned char));
     for (int i = 0; i < this->width * this->height; i++) {
         this->data[i * 4 + 3] = ALPHA;
@@ -182,6 +295,90 @@ void MogStats::init() {
     this->setTextToData(instants, x, y);
     this->positions[INSTANTS] = pair<int, int>(x, y);
 
+    x = startX;
+    y += instantsLabel->height + yMargin;
+    this->setTextToData(glSkippedLabel, x, y);
+    x += glSkippedLabel->width + xMargin;
+    this->setTextToData(glSkipped, x, y);
+    this->positions[GL_SKIPPED] = pair<int, int>(x, y);
+
+    x = startX;
+    y += glSkippedLabel->height + yMargin;
+    this->setTextToData(culledLabel, x, y);
+    x += culledLabel->width + xMargin;
+    this->setTextToData(culled, x, y);
+    this->positions[CULLED] = pair<int, int>(x, y);
+
+    x = startX;
+    y += culledLabel->height + yMargin;
+    this->setTextToData(cacheHitLabel, x, y);
+    x += cacheHitLabel->width + xMargin;
+    this->setTextToData(cacheHit, x, y);
+    this->positions[CACHE_HIT] = pair<int, int>(x, y);
+
+    x = startX;
+    y += cacheHitLabel->height + yMargin;
+    this->setTextToData(cacheMissLabel, x, y);
+    x += cacheMissLabel->width + xMargin;
+    this->setTextToData(cacheMiss, x, y);
+    this->positions[CACHE_MISS] = pair<int, int>(x, y);
+
+    x = startX;
+    y += cacheMissLabel->height + yMargin;
+    this->setTextToData(allocationLabel, x, y);
+    x += allocationLabel->width + xMargin;
+    this->setTextToData(allocation, x, y);
+    this->positions[ALLOCATION] = pair<int, int>(x, y);
+
+    x = startX;
+    y += allocationLabel->height + yMargin;
+    this->setTextToData(batchTimeLabel, x, y);
+    x += batchTimeLabel->width + xMargin;
+    this->setTextToData(batchTime, x, y);
+    this->positions[BATCH_TIME] = pair<int, int>(x, y);
+
+    x = startX;
+    y += batchTimeLabel->height + yMargin;
+    this->setTextToData(atlasLabel, x, y);
+    x += atlasLabel->width + xMargin;
+    this->setTextToData(atlas, x, y);
+    this->positions[ATLAS] = pair<int, int>(x, y);
+
+    x = startX;
+    y += atlasLabel->height + yMargin;
+    this->setTextToData(textureMemoryLabel, x, y);
+    x += textureMemoryLabel->width + xMargin;
+    this->setTextToData(textureMemory, x, y);
+    this->positions[TEXTURE_MEMORY] = pair<int, int>(x, y);
+
+    x = startX;
+    y += textureMemoryLabel->height + yMargin;
+    this->setTextToData(textureSavedLabel, x, y);
+    x += textureSavedLabel->width + xMargin;
+    this->setTextToData(textureSaved, x, y);
+    this->positions[TEXTURE_SAVED] = pair<int, int>(x, y);
+
+    x = startX;
+    y += textureSavedLabel->height + yMargin;
+    this->setTextToData(textureCacheHitLabel, x, y);
+    x += textureCacheHitLabel->width + xMargin;
+    this->setTextToData(textureCacheHit, x, y);
+    this->positions[TEXTURE_CACHE_HIT] = pair<int, int>(x, y);
+
+    x = startX;
+    y += textureCacheHitLabel->height + yMargin;
+    this->setTextToData(textureCacheMissLabel, x, y);
+    x += textureCacheMissLabel->width + xMargin;
+    this->setTextToData(textureCacheMiss, x, y);
+    this->positions[TEXTURE_CACHE_MISS] = pair<int, int>(x, y);
+
+    x = startX;
+    y += textureCacheMissLabel->height + yMargin;
+    this->setTextToData(textureCacheEvictLabel, x, y);
+    x += textureCacheEvictLabel->width + xMargin;
+    this->setTextToData(textureCacheEvict, x, y);
+    this->positions[TEXTURE_CACHE_EVICT] = pair<int, int>(x, y);
+
     this->bindVertex();
     this->initialized = true;
     this->setAlignment(this->alignment);
@@ -275,4 +472,19 @@ void MogStats::updateValues(float delta) {
     this->setNumberToData(delta, 2, 4, this->positions[DELTA].first, this->positions[DELTA].second);
     this->setNumberToData(drawCallCount, 0, 0, this->positions[DRAW_CALL].first, this->positions[DRAW_CALL].second);
     this->setNumberToData(instanceCount, 0, 0, this->positions[INSTANTS].first, this->positions[INSTANTS].second);
+    this->setNumberToData(GLState::skippedCallCount, 0, 0, this->positions[GL_SKIPPED].first, this->positions[GL_SKIPPED].second);
+    this->setNumberToData(culledCount, 0, 0, this->positions[CULLED].first, this->positions[CULLED].second);
+    this->setNumberToData(cacheHitCount, 0, 0, this->positions[CACHE_HIT].first, this->positions[CACHE_HIT].second);
+    this->setNumberToData(cacheMissCount, 0, 0, this->positions[CACHE_MISS].first, this->positions[CACHE_MISS].second);
+    this->setNumberToData(allocationCount, 0, 0, this->positions[ALLOCATION].first, this->positions[ALLOCATION].second);
+    this->setNumberToData(batchRebuildTime, 1, 2, this->positions[BATCH_TIME].first, this->positions[BATCH_TIME].second);
+    // occupancy of the pages of the batching atlases
+    float atlasOccupancy = (atlasPageArea > 0) ? atlasUsedArea * 100.0f / atlasPageArea : 0;
+    this->setNumberToData(atlasOccupancy, 1, 1, this->positions[ATLAS].first, this->positions[ATLAS].second);
+    // texture memory in MB, and the memory saved by the compact types
+    this->setNumberToData(textureBytes / 1048576.0f, 1, 1, this->positions[TEXTURE_MEMORY].first, this->positions[TEXTURE_MEMORY].second);
+    this->setNumberToData((textureRGBABytes - textureBytes) / 1048576.0f, 1, 1, this->positions[TEXTURE_SAVED].first, this->positions[TEXTURE_SAVED].second);
+    this->setNumberToData(textureCacheHitCount, 0, 0, this->positions[TEXTURE_CACHE_HIT].first, this->positions[TEXTURE_CACHE_HIT].second);
+    this->setNumberToData(textureCacheMissCount, 0, 0, this->positions[TEXTURE_CACHE_MISS].first, this->positions[TEXTURE_CACHE_MISS].second);
+    this->setNumberToData(textureCacheEvictCount, 0, 0, this->positions[TEXTURE_CACHE_EVICT].first, this->positions[TEXTURE_CACHE_EVICT].second);
 }
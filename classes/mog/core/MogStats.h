@@ -17,8 +17,28 @@ namespace mog {
     public:
         static int drawCallCount;
         static int instanceCount;
+        static int culledCount;
+        static int cacheHitCount;
+        static int cacheMissCount;
+        static float batchRebuildTime;
+        // areas of the cells and of the pages of the atlases drawn in a frame
+        static long atlasUsedArea;
+        static long atlasPageArea;
+        // bytes of the uploaded textures, and what they would take in RGBA
+        static long textureBytes;
+        static long textureRGBABytes;
+        // lookups and evictions of the texture cache since the start. not reset per frame.
+        static int textureCacheHitCount;
+        static int textureCacheMissCount;
+        static int textureCacheEvictCount;
+        // heap allocations made on the render thread while updating and drawing the scene. only counted with MOG_DEBUG.
+        static int allocationCount;
+        static unsigned long allocatedCount;
+        // set on the render thread during a frame, so the allocations of the loader threads are not counted.
+        static thread_local bool countingAllocations;
 
         static shared_ptr<MogStats> create(bool enable);
+        void updateFrame(const shared_ptr<Engine> &engine, float delta);
         void drawFrame(const shared_ptr<Engine> &engine, float delta);
         bool isEnabled();
         void setEnable(bool enable);
@@ -44,6 +64,7 @@ namespace mog {
         void bindVertex();
         void init();
         void updatePosition();
+        void addDamage();
         void setTextToData(shared_ptr<Texture2D> text, int x, int y);
         void setNumberToData(float value, int intLength, int decimalLength, int x, int y);
         shared_ptr<Texture2D> createLabelTexture(string text);
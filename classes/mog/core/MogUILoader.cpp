@@ -1,6 +1,9 @@
+#include "mog/Constants.h"
 #include "mog/core/MogUILoader.h"
 #include "mog/core/FileUtils.h"
 #include "mog/core/DataStore.h"
+#include "mog/core/TextureAtlas.h"
+#include <algorithm>
 
 using namespace std;
 using namespace mog;
@@ -45,15 +48,158 @@ const std::string MogUILoader::PropertyNames::FrameCount = "frame_count";
 const std::string MogUILoader::PropertyNames::Margin = "margin";
 const std::string MogUILoader::PropertyNames::EnableBatching = "enableBatching";
 const std::string MogUILoader::PropertyNames::ChildEntities = "childEntities";
+const std::string MogUILoader::PropertyNames::Atlas = "atlas";
+const std::string MogUILoader::PropertyNames::AtlasPages = "pages";
+const std::string MogUILoader::PropertyNames::AtlasCells = "cells";
+const std::string MogUILoader::PropertyNames::AtlasPage = "page";
 
 
 std::shared_ptr<mog::Entity> MogUILoader::load(std::string filename) {
     unsigned char *data = nullptr;
     int len = 0;
     FileUtils::readBytesAsset(filename, &data, &len);
-    
+    auto entity = load(data, len);
+    safe_free(data);
+    return entity;
+}
+
+std::shared_ptr<mog::Entity> MogUILoader::loadFile(std::string filepath) {
+    unsigned char *data = nullptr;
+    int len = 0;
+    if (!FileUtils::readDataFromFile(filepath, &data, &len)) {
+        LOGE("MogUILoader::loadFile: file not found: %s", filepath.c_str());
+        return nullptr;
+    }
+    auto entity = load(data, len);
+    safe_free(data);
+    return entity;
+}
+
+std::shared_ptr<mog::Entity> MogUILoader::load(unsigned char *data, int len) {
     auto uiDict = DataStore::deserialize<mog::Dictionary>(data, len);
-    return deserialize(uiDict);
+    
+    // sprites baked into atlas pages are drawn from the pages, without loading their own images
+    unordered_map<string, AtlasRegion> atlasRegions;
+    auto atlasDict = uiDict.get<Dictionary>(PropertyNames::Atlas);
+    if (atlasDict.type == DataType::Dictionary) {
+        loadAtlas(atlasDict, &atlasRegions);
+    }
+    return deserialize(uiDict, atlasRegions);
+}
+
+// the atlas is baked for each density directory. the one of the current density is used, or the nearest one.
+void MogUILoader::loadAtlas(const Dictionary &atlasDict, unordered_map<string, AtlasRegion> *atlasRegions) {
+    Density current = Density::getCurrent();
+    vector<Density> densities;
+    densities.emplace_back(current);
+    for (int i = current.idx + 1; i < Density::allDensities.size(); i++) {
+        densities.emplace_back(Density::allDensities[i]);
+    }
+    for (int i = current.idx - 1; i >= 0; i--) {
+        densities.emplace_back(Density::allDensities[i]);
+    }
+    
+    for (const auto &density : densities) {
+        auto densityDict = atlasDict.get<Dictionary>(density.directory);
+        if (densityDict.type != DataType::Dictionary) continue;
+        
+        auto pagesArr = densityDict.get<Array>(PropertyNames::AtlasPages);
+        vector<shared_ptr<Texture2D>> pages;
+        for (int i = 0; i < pagesArr.size(); i++) {
+            // loaded as an asset of the density, so its container is used and its pixels can be released once uploaded
+            string pageFilename = pagesArr.at<String>(i).value;
+            auto texture = Texture2D::createWithAsset(pageFilename, density);
+            if (texture->data == nullptr) {
+                pages.emplace_back(nullptr);
+                continue;
+            }
+            texture->isAtlasPage = true;
+            pages.emplace_back(texture);
+        }
+        
+        auto cellsDict = densityDict.get<Dictionary>(PropertyNames::AtlasCells);
+        for (const auto &filename : cellsDict.getKeys()) {
+            auto cellDict = cellsDict.get<Dictionary>(filename);
+            int page = cellDict.get<Int>(PropertyNames::AtlasPage).value;
+            if (page < 0 || page >= pages.size() || !pages[page]) continue;
+            
+            AtlasRegion region;
+            region.texture = pages[page];
+            region.rect = Rect(cellDict.get<Int>(PropertyNames::RectX).value / density.value,
+                               cellDict.get<Int>(PropertyNames::RectY).value / density.value,
+                               cellDict.get<Int>(PropertyNames::RectWidth).value / density.value,
+                               cellDict.get<Int>(PropertyNames::RectHeight).value / density.value);
+            (*atlasRegions)[filename] = region;
+        }
+        return;
+    }
+}
+
+// packs the images of the sprites in the entity into atlas pages, named with the prefix and the page number.
+// loadTexture returns nullptr for the images that are not baked. they are loaded one by one at runtime.
+Dictionary MogUILoader::bakeAtlas(const shared_ptr<Entity> &entity, string pagePrefix,
+                                  function<shared_ptr<Texture2D>(string filename)> loadTexture,
+                                  vector<shared_ptr<Texture2D>> *pages) {
+    vector<string> filenames;
+    collectFilenames(entity, &filenames);
+    
+    auto textureAtlas = make_shared<TextureAtlas>();
+    unordered_map<string, shared_ptr<Texture2D>> textures;
+    for (const auto &filename : filenames) {
+        auto texture = loadTexture(filename);
+        if (!texture || texture->width == 0 || texture->height == 0) continue;
+        textures[filename] = texture;
+        textureAtlas->addTexture(texture);
+    }
+    
+    Dictionary dict;
+    if (textures.empty()) return dict;
+    
+    textureAtlas->createTexture();
+    textureAtlas->composeTexture();
+    
+    Array pagesArr;
+    for (int i = 0; i < textureAtlas->getPageCount(); i++) {
+        pagesArr.append(String(pagePrefix + to_string(i) + ".png"));
+        pages->emplace_back(textureAtlas->getTexture(i));
+    }
+    Dictionary cellsDict;
+    for (const auto &pair : textures) {
+        auto cell = textureAtlas->getCell(pair.second);
+        if (!cell || !cell->placed) continue;
+        Dictionary cellDict;
+        cellDict.put(PropertyNames::AtlasPage, Int(cell->page));
+        cellDict.put(PropertyNames::RectX, Int(cell->x));
+        cellDict.put(PropertyNames::RectY, Int(cell->y));
+        cellDict.put(PropertyNames::RectWidth, Int(cell->width));
+        cellDict.put(PropertyNames::RectHeight, Int(cell->height));
+        cellsDict.put(pair.first, cellDict);
+    }
+    dict.put(PropertyNames::AtlasPages, pagesArr);
+    dict.put(PropertyNames::AtlasCells, cellsDict);
+    return dict;
+}
+
+void MogUILoader::collectFilenames(const shared_ptr<Entity> &entity, vector<string> *filenames) {
+    switch (entity->getEntityType()) {
+        case EntityType::Sprite:
+        case EntityType::Slice9Sprite:
+        case EntityType::SpriteSheet: {
+            string filename = static_pointer_cast<Sprite>(entity)->getFilename();
+            if (filename.length() > 0 && find(filenames->begin(), filenames->end(), filename) == filenames->end()) {
+                filenames->emplace_back(filename);
+            }
+            break;
+        }
+        case EntityType::Group: {
+            for (const auto &child : static_pointer_cast<Group>(entity)->getChildEntities()) {
+                collectFilenames(child, filenames);
+            }
+            break;
+        }
+        default:
+            break;
+    }
 }
 
 Dictionary MogUILoader::serialize(const std::shared_ptr<Entity> &entity) {
@@ -144,6 +290,10 @@ Dictionary MogUILoader::serialize(const std::shared_ptr<Entity> &entity) {
 }
 
 std::shared_ptr<Entity> MogUILoader::deserialize(const Dictionary &uiDict) {
+    return deserialize(uiDict, unordered_map<string, AtlasRegion>());
+}
+
+std::shared_ptr<Entity> MogUILoader::deserialize(const Dictionary &uiDict, const std::unordered_map<std::string, AtlasRegion> &atlasRegions) {
     EntityType entityType = (EntityType)(uiDict.get<Int>(PropertyNames::EntityType).value);
     
     string name = uiDict.get<String>(PropertyNames::Name).value;
@@ -197,7 +347,13 @@ std::shared_ptr<Entity> MogUILoader::deserialize(const Dictionary &uiDict) {
             float rectY = uiDict.get<Float>(PropertyNames::RectY).value;
             float rectWidth = uiDict.get<Float>(PropertyNames::RectWidth).value;
             float rectHeight = uiDict.get<Float>(PropertyNames::RectHeight).value;
-            auto sprite = Sprite::create(filename, Rect(rectX, rectY, rectWidth, rectHeight));
+            shared_ptr<Sprite> sprite = nullptr;
+            auto it = atlasRegions.find(filename);
+            if (it != atlasRegions.end()) {
+                sprite = Sprite::createWithAtlasRegion(filename, Rect(rectX, rectY, rectWidth, rectHeight), it->second.texture, it->second.rect);
+            } else {
+                sprite = Sprite::create(filename, Rect(rectX, rectY, rectWidth, rectHeight));
+            }
             
             if (entityType == EntityType::Slice9Sprite) {
                 float centerRectX = uiDict.get<Float>(PropertyNames::CenterRectX).value;
@@ -225,7 +381,7 @@ std::shared_ptr<Entity> MogUILoader::deserialize(const Dictionary &uiDict) {
             auto arr = uiDict.get<Array>(PropertyNames::ChildEntities);
             for (int i = 0; i < arr.size(); i++) {
                 auto childDict = arr.at<Dictionary>(i);
-                auto childEntity = deserialize(childDict);
+                auto childEntity = deserialize(childDict, atlasRegions);
                 group->add(childEntity);
             }
             entity = group;
@@ -3,6 +3,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
 #include "mog/core/Data.h"
 #include "mog/base/Entity.h"
 #include "mog/base/Sprite.h"
@@ -62,11 +65,33 @@ namespace mog {
             static const std::string Margin;
             static const std::string EnableBatching;
             static const std::string ChildEntities;
+            static const std::string Atlas;
+            static const std::string AtlasPages;
+            static const std::string AtlasCells;
+            static const std::string AtlasPage;
+        };
+        
+        // an image of a sprite in a baked atlas page. the rect is in points of the page.
+        struct AtlasRegion {
+            std::shared_ptr<Texture2D> texture;
+            Rect rect;
         };
         
         static std::shared_ptr<mog::Entity> load(std::string filename);
+        // loads a .mogui outside of the assets, e.g. for the headless renderer. the atlas pages are still read from the assets.
+        static std::shared_ptr<mog::Entity> loadFile(std::string filepath);
 
         static Dictionary serialize(const std::shared_ptr<Entity> &entity);
         static std::shared_ptr<Entity> deserialize(const Dictionary &uiDict);
+        static std::shared_ptr<Entity> deserialize(const Dictionary &uiDict, const std::unordered_map<std::string, AtlasRegion> &atlasRegions);
+        
+        static Dictionary bakeAtlas(const std::shared_ptr<Entity> &entity, std::string pagePrefix,
+                                    std::function<std::shared_ptr<Texture2D>(std::string filename)> loadTexture,
+                                    std::vector<std::shared_ptr<Texture2D>> *pages);
+        
+    private:
+        static std::shared_ptr<mog::Entity> load(unsigned char *data, int len);
+        static void loadAtlas(const Dictionary &atlasDict, std::unordered_map<std::string, AtlasRegion> *atlasRegions);
+        static void collectFilenames(const std::shared_ptr<Entity> &entity, std::vector<std::string> *filenames);
     };
 }
@@ -0,0 +1,146 @@
+#include "mog/core/RecordingRenderDevice.h"
+
+using namespace mog;
+
+shared_ptr<RecordingRenderDevice> RecordingRenderDevice::create() {
+    return shared_ptr<RecordingRenderDevice>(new RecordingRenderDevice());
+}
+
+const vector<RenderCommand> &RecordingRenderDevice::getCommands() {
+    return this->commands;
+}
+
+int RecordingRenderDevice::getFrameCount() {
+    return this->frameCount;
+}
+
+int RecordingRenderDevice::getCount(RenderCommandType type) {
+    int count = 0;
+    for (const auto &command : this->commands) {
+        if (command.type == type) count++;
+    }
+    return count;
+}
+
+int RecordingRenderDevice::getUploadedBytes() {
+    int bytes = 0;
+    for (const auto &command : this->commands) {
+        bytes += command.bytes;
+    }
+    return bytes;
+}
+
+void RecordingRenderDevice::clearCommands() {
+    this->commands.clear();
+}
+
+void RecordingRenderDevice::record(RenderCommandType type, unsigned int id, int bytes, int verticesNum, int indicesNum, unsigned int textureId) {
+    RenderCommand command;
+    command.type = type;
+    command.id = id;
+    command.bytes = bytes;
+    command.verticesNum = verticesNum;
+    command.indicesNum = indicesNum;
+    command.textureId = textureId;
+    this->commands.emplace_back(command);
+}
+
+void RecordingRenderDevice::initParameters() {
+}
+
+void RecordingRenderDevice::initScreen(int width, int height) {
+}
+
+void RecordingRenderDevice::beginFrame() {
+    this->commands.clear();
+    this->frameCount++;
+}
+
+void RecordingRenderDevice::clear(const Color &color) {
+    this->record(RenderCommandType::Clear, 0);
+}
+
+void RecordingRenderDevice::setScissor(int x, int y, int width, int height) {
+    this->record(RenderCommandType::Scissor, 0);
+}
+
+void RecordingRenderDevice::disableScissor() {
+}
+
+void RecordingRenderDevice::createBuffers(int num, unsigned int *buffers) {
+    for (int i = 0; i < num; i++) {
+        buffers[i] = this->nextId++;
+        this->record(RenderCommandType::CreateBuffer, buffers[i]);
+    }
+}
+
+void RecordingRenderDevice::deleteBuffers(int num, const unsigned int *buffers) {
+    for (int i = 0; i < num; i++) {
+        this->record(RenderCommandType::DeleteBuffer, buffers[i]);
+    }
+}
+
+void RecordingRenderDevice::uploadVertices(unsigned int buffer, const Vertex *vertices, int verticesNum, bool dynamicDraw) {
+    this->record(RenderCommandType::UploadBuffer, buffer, sizeof(Vertex) * verticesNum, verticesNum);
+}
+
+void RecordingRenderDevice::uploadVerticesSub(unsigned int buffer, int offset, const Vertex *vertices, int verticesNum) {
+    this->record(RenderCommandType::UploadBufferSub, buffer, sizeof(Vertex) * verticesNum, verticesNum);
+}
+
+void RecordingRenderDevice::uploadIndices(unsigned int buffer, const short *indices, int indicesNum, bool dynamicDraw) {
+    this->record(RenderCommandType::UploadBuffer, buffer, sizeof(short) * indicesNum, 0, indicesNum);
+}
+
+void RecordingRenderDevice::uploadIndicesSub(unsigned int buffer, int offset, const short *indices, int indicesNum) {
+    this->record(RenderCommandType::UploadBufferSub, buffer, sizeof(short) * indicesNum, 0, indicesNum);
+}
+
+unsigned int RecordingRenderDevice::createTexture() {
+    unsigned int textureId = this->nextId++;
+    this->record(RenderCommandType::CreateTexture, textureId);
+    return textureId;
+}
+
+void RecordingRenderDevice::deleteTexture(unsigned int textureId) {
+    this->record(RenderCommandType::DeleteTexture, textureId);
+}
+
+void RecordingRenderDevice::uploadTexture(unsigned int textureId, TextureType textureType, int width, int height, const unsigned char *data) {
+    this->record(RenderCommandType::UploadTexture, textureId, width * height * Texture2D::getBytesPerPixel(textureType), 0, 0, textureId);
+}
+
+void RecordingRenderDevice::uploadTextureSub(unsigned int textureId, TextureType textureType, int x, int y, int width, int height, const unsigned char *data) {
+    this->record(RenderCommandType::UploadTextureSub, textureId, width * height * Texture2D::getBytesPerPixel(textureType), 0, 0, textureId);
+}
+
+// the levels are uploaded from the CPU, so their bytes are recorded
+void RecordingRenderDevice::uploadTextureLevel(unsigned int textureId, TextureType textureType, int level, int width, int height, const unsigned char *data) {
+    this->record(RenderCommandType::UploadTexture, textureId, width * height * Texture2D::getBytesPerPixel(textureType), 0, 0, textureId);
+}
+
+void RecordingRenderDevice::setTextureMaxLevel(unsigned int textureId, int maxLevel) {
+}
+
+unsigned int RecordingRenderDevice::createRenderTarget(unsigned int textureId) {
+    unsigned int renderTarget = this->nextId++;
+    this->record(RenderCommandType::CreateRenderTarget, renderTarget, 0, 0, 0, textureId);
+    return renderTarget;
+}
+
+void RecordingRenderDevice::deleteRenderTarget(unsigned int renderTarget) {
+    this->record(RenderCommandType::DeleteRenderTarget, renderTarget);
+}
+
+void RecordingRenderDevice::beginRenderTarget(unsigned int renderTarget, int width, int height) {
+    this->record(RenderCommandType::BeginRenderTarget, renderTarget);
+}
+
+void RecordingRenderDevice::endRenderTarget() {
+    this->record(RenderCommandType::EndRenderTarget, 0);
+}
+
+void RecordingRenderDevice::draw(const DrawCommand &command) {
+    this->record(RenderCommandType::Draw, command.vertexBuffer, 0, command.verticesNum, command.indicesNum,
+                 command.enableTexture ? command.textureId : 0);
+}
@@ -0,0 +1,87 @@
+#ifndef RecordingRenderDevice_h
+#define RecordingRenderDevice_h
+
+#include <vector>
+#include "mog/core/RenderDevice.h"
+
+using namespace std;
+
+namespace mog {
+
+    enum class RenderCommandType {
+        Clear,
+        Scissor,
+        CreateBuffer,
+        DeleteBuffer,
+        UploadBuffer,
+        UploadBufferSub,
+        CreateTexture,
+        DeleteTexture,
+        UploadTexture,
+        UploadTextureSub,
+        CreateRenderTarget,
+        DeleteRenderTarget,
+        BeginRenderTarget,
+        EndRenderTarget,
+        Draw,
+    };
+
+    struct RenderCommand {
+        RenderCommandType type;
+        unsigned int id = 0;
+        int bytes = 0;
+        int verticesNum = 0;
+        int indicesNum = 0;
+        unsigned int textureId = 0;
+    };
+
+    // records every upload and draw instead of talking to a driver.
+    // the command list holds the current frame and is cleared on beginFrame.
+    class RecordingRenderDevice : public RenderDevice {
+    public:
+        static shared_ptr<RecordingRenderDevice> create();
+
+        const vector<RenderCommand> &getCommands();
+        int getFrameCount();
+        int getCount(RenderCommandType type);
+        int getUploadedBytes();
+        void clearCommands();
+
+        virtual void initParameters() override;
+        virtual void initScreen(int width, int height) override;
+        virtual void beginFrame() override;
+        virtual void clear(const Color &color) override;
+        virtual void setScissor(int x, int y, int width, int height) override;
+        virtual void disableScissor() override;
+
+        virtual void createBuffers(int num, unsigned int *buffers) override;
+        virtual void deleteBuffers(int num, const unsigned int *buffers) override;
+        virtual void uploadVertices(unsigned int buffer, const Vertex *vertices, int verticesNum, bool dynamicDraw) override;
+        virtual void uploadVerticesSub(unsigned int buffer, int offset, const Vertex *vertices, int verticesNum) override;
+        virtual void uploadIndices(unsigned int buffer, const short *indices, int indicesNum, bool dynamicDraw) override;
+        virtual void uploadIndicesSub(unsigned int buffer, int offset, const short *indices, int indicesNum) override;
+
+        virtual unsigned int createTexture() override;
+        virtual void deleteTexture(unsigned int textureId) override;
+        virtual void uploadTexture(unsigned int textureId, TextureType textureType, int width, int height, const unsigned char *data) override;
+        virtual void uploadTextureSub(unsigned int textureId, TextureType textureType, int x, int y, int width, int height, const unsigned char *data) override;
+        virtual void uploadTextureLevel(unsigned int textureId, TextureType textureType, int level, int width, int height, const unsigned char *data) override;
+        virtual void setTextureMaxLevel(unsigned int textureId, int maxLevel) override;
+
+        virtual unsigned int createRenderTarget(unsigned int textureId) override;
+        virtual void deleteRenderTarget(unsigned int renderTarget) override;
+        virtual void beginRenderTarget(unsigned int renderTarget, int width, int height) override;
+        virtual void endRenderTarget() override;
+
+        virtual void draw(const DrawCommand &command) override;
+
+    private:
+        vector<RenderCommand> commands;
+        unsigned int nextId = 1;
+        int frameCount = 0;
+
+        void record(RenderCommandType type, unsigned int id, int bytes = 0, int verticesNum = 0, int indicesNum = 0, unsigned int textureId = 0);
+    };
+}
+
+#endif /* RecordingRenderDevice_h */
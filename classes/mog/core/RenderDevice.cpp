@@ -0,0 +1,22 @@
+#include "mog/core/RenderDevice.h"
+#include "mog/core/GLRenderDevice.h"
+
+using namespace mog;
+
+// never destroyed, so static textures released after main returns still reach the device.
+shared_ptr<RenderDevice> *RenderDevice::instance;
+
+const shared_ptr<RenderDevice> &RenderDevice::getInstance() {
+    if (RenderDevice::instance == nullptr) {
+        RenderDevice::instance = new shared_ptr<RenderDevice>(make_shared<GLRenderDevice>());
+    }
+    return *RenderDevice::instance;
+}
+
+void RenderDevice::setInstance(const shared_ptr<RenderDevice> &device) {
+    if (RenderDevice::instance == nullptr) {
+        RenderDevice::instance = new shared_ptr<RenderDevice>(device);
+    } else {
+        *RenderDevice::instance = device;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef RenderDevice_h
+#define RenderDevice_h
+
+#include <memory>
+#include "mog/core/plain_objects.h"
+#include "mog/core/Texture2D.h"
+
+using namespace std;
+
+namespace mog {
+
+    // interleaved vertex layout. all attributes live in one VBO.
+    struct Vertex {
+        float x, y;
+        float u, v;
+        float r, g, b, a;
+    };
+
+    struct DrawCommand {
+        unsigned int vertexBuffer = 0;
+        unsigned int indexBuffer = 0;
+        int verticesNum = 0;
+        int indicesNum = 0;
+        int indicesOffset = 0;
+        unsigned int textureId = 0;
+        bool enableTexture = false;
+        bool enableColor = false;
+        bool premultipliedAlpha = false;
+        float matrix[16];
+        float color[4];
+    };
+
+    // every call to the graphics api goes through the current device.
+    class RenderDevice {
+    public:
+        static const shared_ptr<RenderDevice> &getInstance();
+        static void setInstance(const shared_ptr<RenderDevice> &device);
+
+        virtual ~RenderDevice() {}
+
+        virtual void initParameters() = 0;
+        virtual void initScreen(int width, int height) = 0;
+        virtual void beginFrame() {}
+        virtual void endFrame() {}
+        virtual void clear(const Color &color) = 0;
+        virtual void setScissor(int x, int y, int width, int height) = 0;
+        virtual void disableScissor() = 0;
+
+        virtual void createBuffers(int num, unsigned int *buffers) = 0;
+        virtual void deleteBuffers(int num, const unsigned int *buffers) = 0;
+        virtual void uploadVertices(unsigned int buffer, const Vertex *vertices, int verticesNum, bool dynamicDraw) = 0;
+        virtual void uploadVerticesSub(unsigned int buffer, int offset, const Vertex *vertices, int verticesNum) = 0;
+        virtual void uploadIndices(unsigned int buffer, const short *indices, int indicesNum, bool dynamicDraw) = 0;
+        virtual void uploadIndicesSub(unsigned int buffer, int offset, const short *indices, int indicesNum) = 0;
+
+        virtual unsigned int createTexture() = 0;
+        virtual void deleteTexture(unsigned int textureId) = 0;
+        virtual void uploadTexture(unsigned int textureId, TextureType textureType, int width, int height, const unsigned char *data) = 0;
+        virtual void uploadTextureSub(unsigned int textureId, TextureType textureType, int x, int y, int width, int height, const unsigned char *data) = 0;
+        // uploads a reduced level of the mip chain. level 0 is uploaded with uploadTexture.
+        virtual void uploadTextureLevel(unsigned int textureId, TextureType textureType, int level, int width, int height, const unsigned char *data) = 0;
+        // samples the levels up to maxLevel with trilinear filtering. uploadTexture resets the filter.
+        virtual void setTextureMaxLevel(unsigned int textureId, int maxLevel) = 0;
+        // bytes per pixel of the type in video memory, for the stats
+        virtual int getTextureBytesPerPixel(TextureType textureType) { return Texture2D::getBytesPerPixel(textureType); }
+        // generates the levels from level 0. returns false when the device cannot, the levels are then uploaded from the CPU.
+        virtual bool generateMipmap(unsigned int textureId) { return false; }
+
+        // offscreen targets render into a texture. targets can be nested.
+        virtual unsigned int createRenderTarget(unsigned int textureId) = 0;
+        virtual void deleteRenderTarget(unsigned int renderTarget) = 0;
+        virtual void beginRenderTarget(unsigned int renderTarget, int width, int height) = 0;
+        virtual void endRenderTarget() = 0;
+
+        virtual void draw(const DrawCommand &command) = 0;
+
+    private:
+        static shared_ptr<RenderDevice> *instance;
+    };
+}
+
+#endif /* RenderDevice_h */
@@ -0,0 +1,49 @@
+#include "mog/core/RenderTarget.h"
+#include "mog/core/RenderDevice.h"
+#include "mog/core/Renderer.h"
+#include "mog/core/DrawBatcher.h"
+
+using namespace mog;
+
+shared_ptr<RenderTarget> RenderTarget::create(int width, int height) {
+    auto device = RenderDevice::getInstance();
+    auto renderTarget = shared_ptr<RenderTarget>(new RenderTarget());
+    renderTarget->width = width;
+    renderTarget->height = height;
+    renderTarget->textureId = device->createTexture();
+    device->uploadTexture(renderTarget->textureId, TextureType::RGBA, width, height, nullptr);
+    renderTarget->renderTarget = device->createRenderTarget(renderTarget->textureId);
+    if (renderTarget->renderTarget == 0) return nullptr;
+    return renderTarget;
+}
+
+RenderTarget::RenderTarget() {
+}
+
+RenderTarget::~RenderTarget() {
+    auto device = RenderDevice::getInstance();
+    if (this->renderTarget > 0) {
+        device->deleteRenderTarget(this->renderTarget);
+    }
+    if (this->textureId > 0) {
+        device->deleteTexture(this->textureId);
+    }
+}
+
+void RenderTarget::begin() {
+    // entities batched so far belong to the previous target
+    DrawBatcher::getInstance()->flush();
+    RenderDevice::getInstance()->beginRenderTarget(this->renderTarget, this->width, this->height);
+    RenderDevice::getInstance()->clear(Color(0, 0, 0, 0));
+    
+    // the cull rect is in screen space, so nothing is culled while drawing offscreen
+    Renderer::getCullRect(this->cullRect);
+    Renderer::setCullRect(0, 0, 0, 0);
+}
+
+void RenderTarget::end() {
+    DrawBatcher::getInstance()->flush();
+    RenderDevice::getInstance()->endRenderTarget();
+    Renderer::setCullRect(this->cullRect[0], this->cullRect[1],
+                          this->cullRect[2] - this->cullRect[0], this->cullRect[3] - this->cullRect[1]);
+}
@@ -0,0 +1,33 @@
+#ifndef RenderTarget_h
+#define RenderTarget_h
+
+#include <memory>
+
+using namespace std;
+
+namespace mog {
+
+    // an offscreen texture that entities can be drawn into.
+    // the texture is flipped vertically, the top of the content is at v = 1.
+    class RenderTarget {
+    public:
+        static shared_ptr<RenderTarget> create(int width, int height);
+
+        unsigned int textureId = 0;
+        int width = 0;
+        int height = 0;
+
+        ~RenderTarget();
+
+        void begin();
+        void end();
+
+    private:
+        unsigned int renderTarget = 0;
+        float cullRect[4] = {0, 0, 0, 0};
+
+        RenderTarget();
+    };
+}
+
+#endif /* RenderTarget_h */
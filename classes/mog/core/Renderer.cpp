@@ -2,107 +2,209 @@
 #include "mog/core/Renderer.h"
 #include "mog/core/Engine.h"
 #include "mog/core/MogStats.h"
+#include "mog/core/DrawBatcher.h"
+#include "mog/core/RenderDevice.h"
 #include <math.h>
+#include <string.h>
+#include <stddef.h>
+#include <algorithm>
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define MOG_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MOG_SIMD_NEON
+#endif
 
-using namespace mog;
+// dirty ranges closer than this are uploaded with a single call
+#define DIRTY_RANGE_GAP 16
 
-void checkGLError(const char *label) {
-#ifndef MOG_QT
-    GLenum glError = glGetError();
-    if (glError != GL_NO_ERROR) {
-        LOGE("glError=%d : %s", glError, label);
-    }
-#endif
-}
+using namespace mog;
 
 float Renderer::identityMatrix[16] = {
     1, 0, 0, 0,
     0, 1, 0, 0,
     0, 0, 1, 0,
     0, 0, 0, 1
-};;
+};
+
+float Renderer::currentMatrix[6] = {1.0f, 0, 0, 1.0f, 0, 0};
+float Renderer::currentColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+vector<float> Renderer::matrixStack;
+vector<float> Renderer::colorStack;
+float Renderer::cullRect[4] = {0, 0, 0, 0};
 
 Renderer::Renderer() {
 }
 
 Renderer::~Renderer() {
     if (this->vertexBuffer[0] > 0) {
-        glDeleteBuffers(2, this->vertexBuffer);
-    }
-    if (this->vertexTexCoordsBuffer > 0) {
-        glDeleteBuffers(1, &this->vertexTexCoordsBuffer);
-    }
-    if (this->vertexColorsBuffer > 0) {
-        glDeleteBuffers(1, &this->vertexColorsBuffer);
+        RenderDevice::getInstance()->deleteBuffers(2, this->vertexBuffer);
     }
 }
 
+void Renderer::bindVertex(vector<Vertex> &vertices, vector<short> &indices, int textureId, bool enableColor, bool dynamicDraw) {
+    // swap the contents so the caller can reuse our old storage without reallocating.
+    this->vertices.swap(vertices);
+    this->indices.swap(indices);
+    this->indicesNum = (int)this->indices.size();
+    this->textureId = textureId;
+    this->enableTexture = (textureId > 0);
+    this->enableColor = enableColor;
+    this->dynamicDraw = dynamicDraw;
+    this->dirtyIndices = true;
+    this->setDirty(0, (int)this->vertices.size());
+}
+
 void Renderer::bindVertex(float *vertices, int verticesSize, short *indices, int indicesSize, bool dynamicDraw) {
-    if (this->vertexBuffer[0] == 0) {
-        glGenBuffers(2, this->vertexBuffer);
+    int verticesNum = verticesSize / 2;
+    this->resizeVertices(verticesNum);
+    for (int i = 0; i < verticesNum; i++) {
+        this->vertices[i].x = vertices[i * 2 + 0];
+        this->vertices[i].y = vertices[i * 2 + 1];
     }
-    glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuffer[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * verticesSize, vertices, (dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vertexBuffer[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(short) * indicesSize, indices, (dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    
+    this->indices.assign(indices, indices + indicesSize);
     this->indicesNum = indicesSize;
-
-    checkGLError("bindVertex");
+    this->dynamicDraw = dynamicDraw;
+    this->dirtyIndices = true;
+    this->setDirty(0, verticesNum);
 }
 
 void Renderer::bindTextureVertex(int textureId, float *vertexTexCoords, int size, bool dynamicDraw) {
-    if (this->vertexTexCoordsBuffer == 0) {
-        glGenBuffers(1, &this->vertexTexCoordsBuffer);
+    int verticesNum = size / 2;
+    if (verticesNum > this->vertices.size()) {
+        this->resizeVertices(verticesNum);
+    }
+    for (int i = 0; i < verticesNum; i++) {
+        this->vertices[i].u = vertexTexCoords[i * 2 + 0];
+        this->vertices[i].v = vertexTexCoords[i * 2 + 1];
     }
-    
-    glEnable(GL_TEXTURE_2D);
-    glBindBuffer(GL_ARRAY_BUFFER, this->vertexTexCoordsBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * size, vertexTexCoords, (dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    
     this->textureId = textureId;
     this->enableTexture = true;
-
-    checkGLError("bindTextureVertex");
+    this->dynamicDraw = dynamicDraw;
+    this->setDirty(0, verticesNum);
 }
 
 void Renderer::bindColorsVertex(float *vertexColors, int size, bool dynamicDraw) {
-    if (this->vertexColorsBuffer == 0) {
-        glGenBuffers(1, &this->vertexColorsBuffer);
+    int verticesNum = size / 4;
+    if (verticesNum > this->vertices.size()) {
+        this->resizeVertices(verticesNum);
+    }
+    for (int i = 0; i < verticesNum; i++) {
+        memcpy(&this->vertices[i].r, &vertexColors[i * 4], sizeof(float) * 4);
     }
-    
-    glBindBuffer(GL_ARRAY_BUFFER, this->vertexColorsBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * size, vertexColors, (dynamicDraw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
     this->enableColor = true;
-
-    checkGLError("bindColorsVertex");
+    this->dynamicDraw = dynamicDraw;
+    this->setDirty(0, verticesNum);
 }
 
 void Renderer::bindVertexSub(float *vertices, int size, int offset) {
-    glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuffer[0]);
-    glBufferSubData(GL_ARRAY_BUFFER, offset, sizeof(float) * size, vertices);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    checkGLError("bindVertexSub");
+    int start = (int)(offset / sizeof(float) / 2);
+    int verticesNum = size / 2;
+    if (start + verticesNum > this->vertices.size()) return;
+    for (int i = 0; i < verticesNum; i++) {
+        this->vertices[start + i].x = vertices[i * 2 + 0];
+        this->vertices[start + i].y = vertices[i * 2 + 1];
+    }
+    this->setDirty(start, start + verticesNum);
 }
 
 void Renderer::bindColorsVertexSub(float *vertexColors, int size, int offset) {
-    glBindBuffer(GL_ARRAY_BUFFER, this->vertexColorsBuffer);
-    glBufferSubData(GL_ARRAY_BUFFER, offset, sizeof(float) * size, vertexColors);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    int start = (int)(offset / sizeof(float) / 4);
+    int verticesNum = size / 4;
+    if (start + verticesNum > this->vertices.size()) return;
+    for (int i = 0; i < verticesNum; i++) {
+        memcpy(&this->vertices[start + i].r, &vertexColors[i * 4], sizeof(float) * 4);
+    }
+    this->setDirty(start, start + verticesNum);
+}
 
-    checkGLError("bindColorsVertexSub");
+void Renderer::bindTextureVertexSub(float *vertexTexCoords, int size, int offset) {
+    int start = (int)(offset / sizeof(float) / 2);
+    int verticesNum = size / 2;
+    if (start + verticesNum > this->vertices.size()) return;
+    for (int i = 0; i < verticesNum; i++) {
+        this->vertices[start + i].u = vertexTexCoords[i * 2 + 0];
+        this->vertices[start + i].v = vertexTexCoords[i * 2 + 1];
+    }
+    this->setDirty(start, start + verticesNum);
+}
+
+void Renderer::resizeVertices(int verticesNum) {
+    Vertex v = {0, 0, 0, 0, 1.0f, 1.0f, 1.0f, 1.0f};
+    this->vertices.resize(verticesNum, v);
+}
+
+void Renderer::setDirty(int begin, int end) {
+    this->dirtyBounds = true;
+    if (end <= begin) return;
+    if (begin <= 0 && end >= (int)this->vertices.size()) {
+        this->dirtyRanges.clear();
+    } else if (!this->dirtyRanges.empty()) {
+        auto &last = this->dirtyRanges.back();
+        if (begin <= last.second && end >= last.first) {
+            last.first = min(last.first, begin);
+            last.second = max(last.second, end);
+            return;
+        }
+    }
+    this->dirtyRanges.emplace_back(begin, end);
+}
+
+void Renderer::uploadBuffers() {
+    if (this->dirtyRanges.empty() && !this->dirtyIndices) return;
+    auto &device = RenderDevice::getInstance();
+    
+    if (this->vertexBuffer[0] == 0) {
+        device->createBuffers(2, this->vertexBuffer);
+    }
+    
+    if (!this->dirtyRanges.empty()) {
+        int verticesNum = (int)this->vertices.size();
+        if (verticesNum != this->bufferVerticesNum) {
+            device->uploadVertices(this->vertexBuffer[0], this->vertices.data(), verticesNum, this->dynamicDraw);
+            this->bufferVerticesNum = verticesNum;
+        } else {
+            // upload only the changed ranges, merging the ones that are close to each other
+            sort(this->dirtyRanges.begin(), this->dirtyRanges.end());
+            int begin = this->dirtyRanges[0].first;
+            int end = this->dirtyRanges[0].second;
+            for (int i = 1; i <= this->dirtyRanges.size(); i++) {
+                if (i < this->dirtyRanges.size() && this->dirtyRanges[i].first <= end + DIRTY_RANGE_GAP) {
+                    end = max(end, this->dirtyRanges[i].second);
+                    continue;
+                }
+                begin = max(begin, 0);
+                end = min(end, verticesNum);
+                if (end > begin) {
+                    device->uploadVerticesSub(this->vertexBuffer[0], begin, &this->vertices[begin], end - begin);
+                }
+                if (i < this->dirtyRanges.size()) {
+                    begin = this->dirtyRanges[i].first;
+                    end = this->dirtyRanges[i].second;
+                }
+            }
+        }
+    }
+    
+    if (this->dirtyIndices) {
+        int indicesNum = (int)this->indices.size();
+        if (indicesNum != this->bufferIndicesNum) {
+            device->uploadIndices(this->vertexBuffer[1], this->indices.data(), indicesNum, this->dynamicDraw);
+            this->bufferIndicesNum = indicesNum;
+        } else {
+            device->uploadIndicesSub(this->vertexBuffer[1], 0, this->indices.data(), indicesNum);
+        }
+    }
+    
+    this->dirtyRanges.clear();
+    this->dirtyIndices = false;
 }
 
 void Renderer::drawFrame(const shared_ptr<Transform> &transform, float screenScale) {
+    // keep the draw order of the entities merged by the batcher
+    DrawBatcher::getInstance()->flush();
+    
     this->pushMatrix();
     this->pushColor();
     
@@ -111,114 +213,271 @@ void Renderer::drawFrame(const shared_ptr<Transform> &transform, float screenSca
     
     this->popColor();
     this->popMatrix();
-
-    checkGLError("drawFrame");
 }
 
 void Renderer::drawFrame() {
-    // bind vertex positions
-    glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuffer[0]);
-    glVertexPointer(2, GL_FLOAT, 0, 0);
+    this->uploadBuffers();
     
-    // bind indices
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vertexBuffer[1]);
-
-    if (this->enableTexture) {
-        glEnable(GL_TEXTURE_2D);
-        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-        
-        glBindTexture(GL_TEXTURE_2D, this->textureId);
-        
-        // bind vertex texture coords
-        glBindBuffer(GL_ARRAY_BUFFER, this->vertexTexCoordsBuffer);
-        glTexCoordPointer(2, GL_FLOAT, 0, 0);
+    DrawCommand command;
+    command.vertexBuffer = this->vertexBuffer[0];
+    command.indexBuffer = this->vertexBuffer[1];
+    command.verticesNum = (int)this->vertices.size();
+    command.indicesNum = this->indicesNum;
+    command.textureId = this->textureId;
+    command.enableTexture = this->enableTexture;
+    command.enableColor = this->enableColor;
+    Renderer::toMatrix4x4(Renderer::currentMatrix, command.matrix);
+    memcpy(command.color, Renderer::currentColor, sizeof(float) * 4);
+    command.premultipliedAlpha = this->premultipliedAlpha;
+    if (this->premultipliedAlpha) {
+        command.color[0] *= command.color[3];
+        command.color[1] *= command.color[3];
+        command.color[2] *= command.color[3];
     }
-    
-    if (this->enableColor) {
-        glEnableClientState(GL_COLOR_ARRAY);
-        // bind vertex colors
-        glBindBuffer(GL_ARRAY_BUFFER, this->vertexColorsBuffer);
-        glColorPointer(4, GL_FLOAT, 0, 0);
+    if (this->textureRanges.empty()) {
+        RenderDevice::getInstance()->draw(command);
+        MogStats::drawCallCount++;
+        return;
     }
     
-    // draw
-    glDrawElements(GL_TRIANGLE_STRIP, this->indicesNum, GL_UNSIGNED_SHORT, 0);
-    
-    MogStats::drawCallCount++;
-    
-    // reset
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glDisable(GL_TEXTURE_2D);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-    glDisableClientState(GL_COLOR_ARRAY);
-
-    checkGLError("drawFrame_main");
+    for (const auto &range : this->textureRanges) {
+        command.indicesOffset = range.indicesStart;
+        command.indicesNum = range.indicesNum;
+        command.textureId = range.textureId;
+        RenderDevice::getInstance()->draw(command);
+        MogStats::drawCallCount++;
+    }
 }
 
 void Renderer::applyTransform(const shared_ptr<Transform> &transform, float screenScale, bool enableColor) {
+    float local[6] = {1.0f, 0, 0, 1.0f, 0, 0};
+    
     // translate
-    if (transform->position.x != 0 || transform->anchor.x != 0 || transform->position.y != 0 || transform->anchor.y != 0) {
-        glTranslatef((transform->position.x - (transform->size.width * transform->anchor.x)) * screenScale,
-                     (transform->position.y - (transform->size.height * transform->anchor.y)) * screenScale, 0);
-    }
+    local[4] = (transform->position.x - (transform->size.width * transform->anchor.x)) * screenScale;
+    local[5] = (transform->position.y - (transform->size.height * transform->anchor.y)) * screenScale;
     
-    // move from origin point
     if (transform->rotation != 0 || transform->scale.x != 1.0f || transform->scale.y != 1.0f) {
-        glTranslatef(transform->size.width * transform->anchor.x * screenScale,
-                     transform->size.height * transform->anchor.y * screenScale, 0);
-    }
-    
-    // rotate
-    if (transform->rotation != 0) {
-        glRotatef(transform->rotation, 0, 0, 1.0f);
-    }
-    
-    // scale
-    if (transform->scale.x != 1.0f || transform->scale.y != 1.0f) {
-        glScalef(transform->scale.x, transform->scale.y, 1.0f);
+        float ax = transform->size.width * transform->anchor.x * screenScale;
+        float ay = transform->size.height * transform->anchor.y * screenScale;
+        
+        // rotate and scale
+        float rad = transform->rotation * (M_PI / 180.0f);
+        float c = (transform->rotation != 0) ? cosf(rad) : 1.0f;
+        float s = (transform->rotation != 0) ? sinf(rad) : 0;
+        local[0] = c * transform->scale.x;
+        local[1] = s * transform->scale.x;
+        local[2] = -s * transform->scale.y;
+        local[3] = c * transform->scale.y;
+        
+        // around the origin point
+        local[4] += ax - (local[0] * ax + local[2] * ay);
+        local[5] += ay - (local[1] * ax + local[3] * ay);
     }
     
-    // move to origin point
-    if (transform->rotation != 0 || transform->scale.x != 1.0f || transform->scale.y != 1.0f) {
-        glTranslatef(transform->size.width * -transform->anchor.x * screenScale,
-                     transform->size.height * -transform->anchor.y * screenScale, 0);
-    }
+    float *m = Renderer::currentMatrix;
+    float result[6] = {
+        m[0] * local[0] + m[2] * local[1],
+        m[1] * local[0] + m[3] * local[1],
+        m[0] * local[2] + m[2] * local[3],
+        m[1] * local[2] + m[3] * local[3],
+        m[0] * local[4] + m[2] * local[5] + m[4],
+        m[1] * local[4] + m[3] * local[5] + m[5],
+    };
+    memcpy(Renderer::currentMatrix, result, sizeof(float) * 6);
+    Renderer::toMatrix4x4(Renderer::currentMatrix, this->matrix);
     
     // color
     if (enableColor) {
-        if (transform->color.r < 1.0f || transform->color.g < 1.0f || transform->color.b < 1.0f || transform->color.a < 1.0f) {
-            glColor4f(transform->color.r * this->_color[0], transform->color.g * this->_color[1],
-                      transform->color.b * this->_color[2], transform->color.a * this->_color[3]);
-        }
+        float *c = Renderer::currentColor;
+        c[0] *= transform->color.r;
+        c[1] *= transform->color.g;
+        c[2] *= transform->color.b;
+        c[3] *= transform->color.a;
+        memcpy(this->color, c, sizeof(float) * 4);
     }
-    
-    glGetFloatv(GL_MODELVIEW_MATRIX, this->matrix);
+}
+
+void Renderer::transformVertices(const float *matrix, const Vertex *src, Vertex *dst, int verticesNum) {
+    int i = 0;
+#if defined(MOG_SIMD_SSE)
+    __m128 mx = _mm_setr_ps(matrix[0], matrix[1], matrix[0], matrix[1]);
+    __m128 my = _mm_setr_ps(matrix[4], matrix[5], matrix[4], matrix[5]);
+    __m128 mt = _mm_setr_ps(matrix[12], matrix[13], matrix[12], matrix[13]);
+    for (; i + 2 <= verticesNum; i += 2) {
+        __m128 v = _mm_setzero_ps();
+        v = _mm_loadl_pi(v, (const __m64 *)&src[i].x);
+        v = _mm_loadh_pi(v, (const __m64 *)&src[i + 1].x);
+        __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, mx), _mm_mul_ps(y, my)), mt);
+        _mm_storel_pi((__m64 *)&dst[i].x, r);
+        _mm_storeh_pi((__m64 *)&dst[i + 1].x, r);
+    }
+#elif defined(MOG_SIMD_NEON)
+    float32x2_t mx = {matrix[0], matrix[1]};
+    float32x2_t my = {matrix[4], matrix[5]};
+    float32x2_t mt = {matrix[12], matrix[13]};
+    for (; i < verticesNum; i++) {
+        float32x2_t v = vld1_f32(&src[i].x);
+        float32x2_t r = vmla_lane_f32(vmla_lane_f32(mt, mx, v, 0), my, v, 1);
+        vst1_f32(&dst[i].x, r);
+    }
+#endif
+    for (; i < verticesNum; i++) {
+        float x = src[i].x;
+        float y = src[i].y;
+        dst[i].x = matrix[0] * x + matrix[4] * y + matrix[12];
+        dst[i].y = matrix[1] * x + matrix[5] * y + matrix[13];
+    }
+}
+
+void Renderer::toMatrix4x4(const float *affine, float *matrix) {
+    memcpy(matrix, Renderer::identityMatrix, sizeof(float) * 16);
+    matrix[0] = affine[0];
+    matrix[1] = affine[1];
+    matrix[4] = affine[2];
+    matrix[5] = affine[3];
+    matrix[12] = affine[4];
+    matrix[13] = affine[5];
+}
+
+bool Renderer::isEnableTexture() {
+    return this->enableTexture;
+}
 
-    checkGLError("applyTransform");
+bool Renderer::isEnableColor() {
+    return this->enableColor;
 }
 
 void Renderer::getMatrix(float *matrix) {
-    glGetFloatv(GL_MODELVIEW_MATRIX, matrix);
+    Renderer::toMatrix4x4(Renderer::currentMatrix, matrix);
 }
 
 void Renderer::setMatrix(float *matrix) {
-    glLoadMatrixf(matrix);
+    float *m = Renderer::currentMatrix;
+    m[0] = matrix[0];
+    m[1] = matrix[1];
+    m[2] = matrix[4];
+    m[3] = matrix[5];
+    m[4] = matrix[12];
+    m[5] = matrix[13];
 }
 
 void Renderer::pushMatrix() {
-    glPushMatrix();
+    Renderer::matrixStack.insert(Renderer::matrixStack.end(), Renderer::currentMatrix, Renderer::currentMatrix + 6);
 }
 
 void Renderer::popMatrix() {
-    glPopMatrix();
+    if (Renderer::matrixStack.size() < 6) return;
+    memcpy(Renderer::currentMatrix, &Renderer::matrixStack[Renderer::matrixStack.size() - 6], sizeof(float) * 6);
+    Renderer::matrixStack.resize(Renderer::matrixStack.size() - 6);
 }
 
 void Renderer::pushColor() {
-    glGetFloatv(GL_CURRENT_COLOR, this->_color);
+    Renderer::colorStack.insert(Renderer::colorStack.end(), Renderer::currentColor, Renderer::currentColor + 4);
 }
 
 void Renderer::popColor() {
-    glColor4f(this->_color[0], this->_color[1], this->_color[2], this->_color[3]);
+    if (Renderer::colorStack.size() < 4) return;
+    memcpy(Renderer::currentColor, &Renderer::colorStack[Renderer::colorStack.size() - 4], sizeof(float) * 4);
+    Renderer::colorStack.resize(Renderer::colorStack.size() - 4);
+}
+
+void Renderer::setColor(const Color &color) {
+    Renderer::currentColor[0] = color.r;
+    Renderer::currentColor[1] = color.g;
+    Renderer::currentColor[2] = color.b;
+    Renderer::currentColor[3] = color.a;
+}
+
+void Renderer::setCullRect(float x, float y, float width, float height) {
+    Renderer::cullRect[0] = x;
+    Renderer::cullRect[1] = y;
+    Renderer::cullRect[2] = x + width;
+    Renderer::cullRect[3] = y + height;
+}
+
+void Renderer::getCullRect(float *bounds) {
+    memcpy(bounds, Renderer::cullRect, sizeof(float) * 4);
+}
+
+bool Renderer::isInCullRect(const float *bounds) {
+    // culling is disabled until the screen size is known
+    if (Renderer::cullRect[2] <= Renderer::cullRect[0] || Renderer::cullRect[3] <= Renderer::cullRect[1]) return true;
+    return !(bounds[2] < Renderer::cullRect[0] || bounds[0] > Renderer::cullRect[2] ||
+             bounds[3] < Renderer::cullRect[1] || bounds[1] > Renderer::cullRect[3]);
+}
+
+void Renderer::transformBounds(const float *bounds, float *out) {
+    const float *m = Renderer::currentMatrix;
+    float xs[4] = {bounds[0], bounds[2], bounds[0], bounds[2]};
+    float ys[4] = {bounds[1], bounds[1], bounds[3], bounds[3]};
+    for (int i = 0; i < 4; i++) {
+        float x = m[0] * xs[i] + m[2] * ys[i] + m[4];
+        float y = m[1] * xs[i] + m[3] * ys[i] + m[5];
+        if (i == 0) {
+            out[0] = out[2] = x;
+            out[1] = out[3] = y;
+        } else {
+            out[0] = min(out[0], x);
+            out[1] = min(out[1], y);
+            out[2] = max(out[2], x);
+            out[3] = max(out[3], y);
+        }
+    }
+}
+
+void Renderer::inverseTransformBounds(const float *bounds, float *out) {
+    const float *m = Renderer::currentMatrix;
+    float det = m[0] * m[3] - m[1] * m[2];
+    if (det == 0) {
+        memcpy(out, bounds, sizeof(float) * 4);
+        return;
+    }
+    float inv[6] = {
+        m[3] / det, -m[1] / det,
+        -m[2] / det, m[0] / det,
+        (m[2] * m[5] - m[3] * m[4]) / det,
+        (m[1] * m[4] - m[0] * m[5]) / det,
+    };
+    float xs[4] = {bounds[0], bounds[2], bounds[0], bounds[2]};
+    float ys[4] = {bounds[1], bounds[1], bounds[3], bounds[3]};
+    for (int i = 0; i < 4; i++) {
+        float x = inv[0] * xs[i] + inv[2] * ys[i] + inv[4];
+        float y = inv[1] * xs[i] + inv[3] * ys[i] + inv[5];
+        if (i == 0) {
+            out[0] = out[2] = x;
+            out[1] = out[3] = y;
+        } else {
+            out[0] = min(out[0], x);
+            out[1] = min(out[1], y);
+            out[2] = max(out[2], x);
+            out[3] = max(out[3], y);
+        }
+    }
+}
+
+bool Renderer::getLocalBounds(float *bounds) {
+    if (this->vertices.size() == 0) return false;
+    if (this->dirtyBounds) {
+        const auto &v = this->vertices;
+        this->localBounds[0] = this->localBounds[2] = v[0].x;
+        this->localBounds[1] = this->localBounds[3] = v[0].y;
+        for (size_t i = 1; i < v.size(); i++) {
+            this->localBounds[0] = min(this->localBounds[0], v[i].x);
+            this->localBounds[1] = min(this->localBounds[1], v[i].y);
+            this->localBounds[2] = max(this->localBounds[2], v[i].x);
+            this->localBounds[3] = max(this->localBounds[3], v[i].y);
+        }
+        this->dirtyBounds = false;
+    }
+    memcpy(bounds, this->localBounds, sizeof(float) * 4);
+    return true;
+}
+
+bool Renderer::getWorldBounds(float *bounds) {
+    float local[4];
+    if (!this->getLocalBounds(local)) return false;
+    Renderer::transformBounds(local, bounds);
+    return true;
 }
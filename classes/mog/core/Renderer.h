@@ -2,15 +2,10 @@
 #define Renderer_h
 
 #include <vector>
-#include "mog/core/opengl.h"
 #include "mog/core/Transform.h"
+#include "mog/core/RenderDevice.h"
 #include "mog/core/plain_objects.h"
 
-#define VBO_VERTICES 0
-#define VBO_INDICES 1
-#define VBO_TEXTURES 2
-#define VBO_COLORS 3
-
 using namespace std;
 
 namespace mog {
@@ -18,6 +13,13 @@ namespace mog {
     
     class Renderer {
     public:
+        // a part of the indices drawn with its own texture.
+        struct TextureRange {
+            int indicesStart;
+            int indicesNum;
+            int textureId;
+        };
+        
         static float identityMatrix[16];
 
         int indicesNum = 0;
@@ -28,18 +30,31 @@ namespace mog {
             0, 0, 1, 0,
             0, 0, 0, 1,
         };
+        float color[4] = {1, 1, 1, 1};
+        bool premultipliedAlpha = false;
+        
+        // cpu side copies of the bound geometry. uploaded to GL lazily on drawFrame.
+        vector<Vertex> vertices;
+        vector<short> indices;
+        // drawn instead of textureId when the indices span several textures.
+        vector<TextureRange> textureRanges;
 
         Renderer();
         ~Renderer();
         
+        void bindVertex(vector<Vertex> &vertices, vector<short> &indices, int textureId, bool enableColor, bool dynamicDraw = false);
         void bindVertex(float *vertices, int verticesSize, short *indices, int indicesSize, bool dynamicDraw = false);
         void bindTextureVertex(int textureId, float *vertexTexCoords, int size, bool dynamicDraw = false);
         void bindColorsVertex(float *vertexColors, int size, bool dynamicDraw = false);
 
         void bindVertexSub(float *vertices, int verticesNum, int offset = 0);
         void bindColorsVertexSub(float *vertexColors, int size, int offset = 0);
+        void bindTextureVertexSub(float *vertexTexCoords, int size, int offset = 0);
 
         void drawFrame(const shared_ptr<Transform> &transform, float screenScale);
+        void drawFrame();
+        bool isEnableTexture();
+        bool isEnableColor();
 
         void applyTransform(const shared_ptr<Transform> &transform, float screenScale, bool enableColor = true);
         void getMatrix(float *matrix);
@@ -48,17 +63,44 @@ namespace mog {
         void popMatrix();
         void pushColor();
         void popColor();
+        void setColor(const Color &color);
+        
+        static void transformVertices(const float *matrix, const Vertex *src, Vertex *dst, int verticesNum);
+        
+        // bounds are [minX, minY, maxX, maxY] in pixels
+        static void setCullRect(float x, float y, float width, float height);
+        static void getCullRect(float *bounds);
+        static bool isInCullRect(const float *bounds);
+        static void transformBounds(const float *bounds, float *out);
+        static void inverseTransformBounds(const float *bounds, float *out);
+        bool getLocalBounds(float *bounds);
+        bool getWorldBounds(float *bounds);
         
     private:
-        GLuint vertexBuffer[2] = {0, 0};
-        GLuint vertexTexCoordsBuffer = 0;
-        GLuint vertexColorsBuffer = 0;
+        unsigned int vertexBuffer[2] = {0, 0};
+        int bufferVerticesNum = 0;
+        int bufferIndicesNum = 0;
         
         bool enableTexture = false;
         bool enableColor = false;
-        float _color[4] = {1, 1, 1, 1};
+        bool dynamicDraw = false;
+        bool dirtyIndices = false;
+        // [begin, end) vertex ranges changed since the last upload
+        vector<pair<int, int>> dirtyRanges;
+        bool dirtyBounds = true;
+        float localBounds[4] = {0, 0, 0, 0};
         
-        void drawFrame();
+        // software matrix stack. matrices are 2d affine [a, b, c, d, tx, ty].
+        static float currentMatrix[6];
+        static float currentColor[4];
+        static vector<float> matrixStack;
+        static vector<float> colorStack;
+        static float cullRect[4];
+        
+        static void toMatrix4x4(const float *affine, float *matrix);
+        void resizeVertices(int verticesNum);
+        void setDirty(int begin, int end);
+        void uploadBuffers();
     };
 }
 
@@ -0,0 +1,313 @@
+#include "mog/Constants.h"
+#include "mog/core/ShaderRenderDevice.h"
+#include "mog/core/GLState.h"
+#include "mog/core/opengl.h"
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#ifndef MOG_SOFTWARE_RENDERER
+
+using namespace mog;
+
+#if defined(MOG_OSX) || defined(MOG_QT)
+// the legacy context on macOS provides vertex array objects through the APPLE extension
+#define glGenVertexArrays glGenVertexArraysAPPLE
+#define glDeleteVertexArrays glDeleteVertexArraysAPPLE
+#define glBindVertexArray glBindVertexArrayAPPLE
+#endif
+
+extern void checkGLError(const char *label);
+
+#define ATTRIBUTE_POSITION 0
+#define ATTRIBUTE_TEX_COORD 1
+#define ATTRIBUTE_COLOR 2
+
+// one source for every built-in program, the features are selected by defines.
+// GLSL 1.10 and GLSL ES 1.00 both accept it.
+static const char *vertexShaderSource =
+    "attribute vec2 a_position;\n"
+    "attribute vec2 a_texCoord;\n"
+    "attribute vec4 a_color;\n"
+    "uniform mat4 u_mvp;\n"
+    "varying vec2 v_texCoord;\n"
+    "varying vec4 v_color;\n"
+    "void main() {\n"
+    "    gl_Position = u_mvp * vec4(a_position, 0.0, 1.0);\n"
+    "#ifdef USE_TEXTURE\n"
+    "    v_texCoord = a_texCoord;\n"
+    "#endif\n"
+    "#ifdef USE_COLOR\n"
+    "    v_color = a_color;\n"
+    "#endif\n"
+    "}\n";
+
+static const char *fragmentShaderSource =
+    "#ifdef GL_ES\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "uniform sampler2D u_texture;\n"
+    "uniform vec4 u_tint;\n"
+    "varying vec2 v_texCoord;\n"
+    "varying vec4 v_color;\n"
+    "void main() {\n"
+    "    vec4 color = u_tint;\n"
+    "#ifdef USE_ALPHA_TEXTURE\n"
+    "    color.a *= texture2D(u_texture, v_texCoord).a;\n"
+    "#elif defined(USE_TEXTURE)\n"
+    "    color *= texture2D(u_texture, v_texCoord);\n"
+    "#endif\n"
+    "#ifdef USE_COLOR\n"
+    "    color *= v_color;\n"
+    "#endif\n"
+    "    gl_FragColor = color;\n"
+    "}\n";
+
+static GLuint compileShader(GLenum type, const string &source) {
+    GLuint shader = glCreateShader(type);
+    const char *src = source.c_str();
+    glShaderSource(shader, 1, &src, nullptr);
+    glCompileShader(shader);
+
+    GLint compiled = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        char log[512];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LOGE("compileShader: %s", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static void multiplyMatrix(const float *a, const float *b, float *out) {
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            out[col * 4 + row] = a[0 * 4 + row] * b[col * 4 + 0] +
+                                 a[1 * 4 + row] * b[col * 4 + 1] +
+                                 a[2 * 4 + row] * b[col * 4 + 2] +
+                                 a[3 * 4 + row] * b[col * 4 + 3];
+        }
+    }
+}
+
+shared_ptr<ShaderRenderDevice> ShaderRenderDevice::create() {
+    return shared_ptr<ShaderRenderDevice>(new ShaderRenderDevice());
+}
+
+ShaderRenderDevice::ShaderRenderDevice() {
+}
+
+ShaderRenderDevice::~ShaderRenderDevice() {
+    for (auto &program : this->programs) {
+        if (program.program > 0) {
+            glDeleteProgram(program.program);
+        }
+    }
+    for (auto &pair : this->vertexArrays) {
+        glDeleteVertexArrays(1, &pair.second.vertexArray);
+    }
+}
+
+bool ShaderRenderDevice::compilePrograms() {
+    for (int i = 0; i < SHADER_PROGRAM_NUM; i++) {
+        if (this->programs[i].program > 0) continue;
+        if ((i & SHADER_PROGRAM_ALPHA_TEXTURE) && !(i & SHADER_PROGRAM_TEXTURE)) continue;
+        if (!this->compileProgram(this->programs[i], i)) return false;
+    }
+    return true;
+}
+
+bool ShaderRenderDevice::compileProgram(ShaderProgram &program, int features) {
+    string defines = "";
+    if ((features & SHADER_PROGRAM_TEXTURE) == SHADER_PROGRAM_TEXTURE) {
+        defines += "#define USE_TEXTURE\n";
+    }
+    if ((features & SHADER_PROGRAM_COLOR) == SHADER_PROGRAM_COLOR) {
+        defines += "#define USE_COLOR\n";
+    }
+    if ((features & SHADER_PROGRAM_ALPHA_TEXTURE) == SHADER_PROGRAM_ALPHA_TEXTURE) {
+        defines += "#define USE_ALPHA_TEXTURE\n";
+    }
+
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, defines + vertexShaderSource);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, defines + fragmentShaderSource);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    GLuint p = glCreateProgram();
+    glAttachShader(p, vertexShader);
+    glAttachShader(p, fragmentShader);
+    glBindAttribLocation(p, ATTRIBUTE_POSITION, "a_position");
+    glBindAttribLocation(p, ATTRIBUTE_TEX_COORD, "a_texCoord");
+    glBindAttribLocation(p, ATTRIBUTE_COLOR, "a_color");
+    glLinkProgram(p);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint linked = 0;
+    glGetProgramiv(p, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[512];
+        glGetProgramInfoLog(p, sizeof(log), nullptr, log);
+        LOGE("compileProgram: %s", log);
+        glDeleteProgram(p);
+        return false;
+    }
+
+    program.program = p;
+    program.mvpLocation = glGetUniformLocation(p, "u_mvp");
+    program.tintLocation = glGetUniformLocation(p, "u_tint");
+    this->useProgram(p);
+    glUniform1i(glGetUniformLocation(p, "u_texture"), 0);
+    return true;
+}
+
+void ShaderRenderDevice::initParameters() {
+    GLState::invalidate();
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_DITHER);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_CULL_FACE);
+    glActiveTexture(GL_TEXTURE0);
+    this->currentProgram = 0;
+    this->currentVertexArray = 0;
+    this->compilePrograms();
+}
+
+void ShaderRenderDevice::setViewport(int width, int height) {
+    glViewport(0, 0, width, height);
+
+    // same projection as glOrthof(0, width, height, 0, -1, 1)
+    float *m = this->projection;
+    memset(m, 0, sizeof(float) * 16);
+    m[0] = 2.0f / width;
+    m[5] = -2.0f / height;
+    m[10] = -1.0f;
+    m[12] = -1.0f;
+    m[13] = 1.0f;
+    m[15] = 1.0f;
+}
+
+void ShaderRenderDevice::deleteBuffers(int num, const unsigned int *buffers) {
+    for (int i = 0; i < num; i++) {
+        auto it = this->vertexArrays.find(buffers[i]);
+        if (it == this->vertexArrays.end()) continue;
+        if (this->currentVertexArray == it->second.vertexArray) {
+            this->bindVertexArray(0);
+        }
+        glDeleteVertexArrays(1, &it->second.vertexArray);
+        this->vertexArrays.erase(it);
+    }
+    GLRenderDevice::deleteBuffers(num, buffers);
+}
+
+// the element array binding belongs to the bound vertex array, so uploads go through the default one
+void ShaderRenderDevice::uploadIndices(unsigned int buffer, const short *indices, int indicesNum, bool dynamicDraw) {
+    this->bindVertexArray(0);
+    GLRenderDevice::uploadIndices(buffer, indices, indicesNum, dynamicDraw);
+}
+
+void ShaderRenderDevice::uploadIndicesSub(unsigned int buffer, int offset, const short *indices, int indicesNum) {
+    this->bindVertexArray(0);
+    GLRenderDevice::uploadIndicesSub(buffer, offset, indices, indicesNum);
+}
+
+void ShaderRenderDevice::deleteTexture(unsigned int textureId) {
+    this->alphaTextures.erase(textureId);
+    GLRenderDevice::deleteTexture(textureId);
+}
+
+void ShaderRenderDevice::uploadTexture(unsigned int textureId, TextureType textureType, int width, int height, const unsigned char *data) {
+    if (textureType == TextureType::A8) {
+        this->alphaTextures.insert(textureId);
+    } else {
+        this->alphaTextures.erase(textureId);
+    }
+    GLRenderDevice::uploadTexture(textureId, textureType, width, height, data);
+}
+
+void ShaderRenderDevice::useProgram(unsigned int program) {
+    if (this->currentProgram == program) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glUseProgram(program);
+    this->currentProgram = program;
+}
+
+void ShaderRenderDevice::bindVertexArray(unsigned int vertexArray) {
+    if (this->currentVertexArray == vertexArray) {
+        GLState::skippedCallCount++;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    this->currentVertexArray = vertexArray;
+}
+
+unsigned int ShaderRenderDevice::getVertexArray(unsigned int vertexBuffer, unsigned int indexBuffer) {
+    auto &vertexArray = this->vertexArrays[vertexBuffer];
+    if (vertexArray.vertexArray > 0 && vertexArray.indexBuffer == indexBuffer) {
+        return vertexArray.vertexArray;
+    }
+
+    if (vertexArray.vertexArray == 0) {
+        glGenVertexArrays(1, &vertexArray.vertexArray);
+    }
+    vertexArray.indexBuffer = indexBuffer;
+    this->bindVertexArray(vertexArray.vertexArray);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glEnableVertexAttribArray(ATTRIBUTE_POSITION);
+    glVertexAttribPointer(ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, x));
+    glEnableVertexAttribArray(ATTRIBUTE_TEX_COORD);
+    glVertexAttribPointer(ATTRIBUTE_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, u));
+    glEnableVertexAttribArray(ATTRIBUTE_COLOR);
+    glVertexAttribPointer(ATTRIBUTE_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, r));
+    // not tracked by GLState, the binding is stored in the vertex array
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    return vertexArray.vertexArray;
+}
+
+void ShaderRenderDevice::draw(const DrawCommand &command) {
+    int features = 0;
+    if (command.enableTexture) features |= SHADER_PROGRAM_TEXTURE;
+    if (command.enableColor) features |= SHADER_PROGRAM_COLOR;
+    if (command.enableTexture && this->alphaTextures.count(command.textureId) > 0) features |= SHADER_PROGRAM_ALPHA_TEXTURE;
+    auto &program = this->programs[features];
+    if (program.program == 0) return;
+
+    this->useProgram(program.program);
+
+    float mvp[16];
+    multiplyMatrix(this->projection, command.matrix, mvp);
+    glUniformMatrix4fv(program.mvpLocation, 1, GL_FALSE, mvp);
+
+    // the vertex colors replace the current color, as in the fixed-function pipeline
+    static const float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float *tint = command.enableColor ? white : command.color;
+    if (memcmp(program.tint, tint, sizeof(float) * 4) != 0) {
+        glUniform4fv(program.tintLocation, 1, tint);
+        memcpy(program.tint, tint, sizeof(float) * 4);
+    } else {
+        GLState::skippedCallCount++;
+    }
+    this->applyBlendFunc(command.premultipliedAlpha);
+
+    if (command.enableTexture) {
+        GLState::bindTexture(command.textureId);
+    }
+    this->bindVertexArray(this->getVertexArray(command.vertexBuffer, command.indexBuffer));
+
+    glDrawElements(GL_TRIANGLE_STRIP, command.indicesNum, GL_UNSIGNED_SHORT, (void *)(sizeof(short) * command.indicesOffset));
+
+    checkGLError("draw");
+}
+
+#endif
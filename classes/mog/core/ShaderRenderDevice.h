@@ -0,0 +1,67 @@
+#ifndef ShaderRenderDevice_h
+#define ShaderRenderDevice_h
+
+#include <unordered_map>
+#include <unordered_set>
+#include "mog/core/GLRenderDevice.h"
+
+#define SHADER_PROGRAM_TEXTURE 1
+#define SHADER_PROGRAM_COLOR 2
+// A8 textures sample (0, 0, 0, a) in GLSL, only their alpha is applied
+#define SHADER_PROGRAM_ALPHA_TEXTURE 4
+#define SHADER_PROGRAM_NUM 8
+
+namespace mog {
+
+    // draws with GLSL programs instead of the fixed-function pipeline.
+    // the matrix and the tint color are uniforms, vertex attributes are bound through a VAO per vertex buffer.
+    // buffers, textures and render targets are shared with GLRenderDevice.
+    class ShaderRenderDevice : public GLRenderDevice {
+    public:
+        static shared_ptr<ShaderRenderDevice> create();
+
+        ~ShaderRenderDevice();
+
+        bool compilePrograms();
+
+        virtual void initParameters() override;
+        virtual void deleteBuffers(int num, const unsigned int *buffers) override;
+        virtual void uploadIndices(unsigned int buffer, const short *indices, int indicesNum, bool dynamicDraw) override;
+        virtual void uploadIndicesSub(unsigned int buffer, int offset, const short *indices, int indicesNum) override;
+        virtual void deleteTexture(unsigned int textureId) override;
+        virtual void uploadTexture(unsigned int textureId, TextureType textureType, int width, int height, const unsigned char *data) override;
+        virtual void draw(const DrawCommand &command) override;
+
+    protected:
+        virtual void setViewport(int width, int height) override;
+
+    private:
+        struct ShaderProgram {
+            unsigned int program = 0;
+            int mvpLocation = -1;
+            int tintLocation = -1;
+            float tint[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+        };
+
+        struct VertexArray {
+            unsigned int vertexArray = 0;
+            unsigned int indexBuffer = 0;
+        };
+
+        ShaderProgram programs[SHADER_PROGRAM_NUM];
+        unordered_map<unsigned int, VertexArray> vertexArrays;
+        unordered_set<unsigned int> alphaTextures;
+        unsigned int currentProgram = 0;
+        unsigned int currentVertexArray = 0;
+        float projection[16];
+
+        ShaderRenderDevice();
+
+        bool compileProgram(ShaderProgram &program, int features);
+        void useProgram(unsigned int program);
+        void bindVertexArray(unsigned int vertexArray);
+        unsigned int getVertexArray(unsigned int vertexBuffer, unsigned int indexBuffer);
+    };
+}
+
+#endif /* ShaderRenderDevice_h */
@@ -0,0 +1,830 @@
+#ifdef MOG_SOFTWARE_RENDERER
+
+#include "mog/core/SoftwareGL.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+using namespace mog;
+
+namespace {
+    struct SGLBuffer {
+        vector<unsigned char> data;
+    };
+
+    struct SGLTexture {
+        int width = 0;
+        int height = 0;
+        GLint minFilter = GL_LINEAR;
+        GLint magFilter = GL_LINEAR;
+        vector<unsigned char> pixels;
+    };
+
+    struct SGLPointer {
+        GLint size = 4;
+        GLenum type = GL_FLOAT;
+        GLsizei stride = 0;
+        GLuint buffer = 0;
+        const GLvoid *pointer = nullptr;
+    };
+
+    struct SGLVertex {
+        float x, y;
+        float u, v;
+        float color[4];
+    };
+
+    struct SGLTarget {
+        unsigned char *pixels = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+
+    struct SGLContext {
+        int width = 0;
+        int height = 0;
+        vector<unsigned char> framebuffer;
+
+        GLint viewport[4] = {0, 0, 0, 0};
+        GLint scissor[4] = {0, 0, 0, 0};
+        GLfloat clearColor[4] = {0, 0, 0, 0};
+        GLfloat color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        bool enableTexture = false;
+        bool enableBlend = false;
+        bool enableScissor = false;
+        bool enableVertexArray = false;
+        bool enableTexCoordArray = false;
+        bool enableColorArray = false;
+        GLenum blendSrc = GL_ONE;
+        GLenum blendDst = GL_ZERO;
+        GLenum blendSrcAlpha = GL_ONE;
+        GLenum blendDstAlpha = GL_ZERO;
+        GLint unpackAlignment = 4;
+
+        GLenum matrixMode = GL_MODELVIEW;
+        GLfloat modelview[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        GLfloat projection[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+        GLuint nextId = 1;
+        unordered_map<GLuint, SGLBuffer> buffers;
+        unordered_map<GLuint, SGLTexture> textures;
+        unordered_map<GLuint, GLuint> framebuffers;
+        GLuint boundFramebuffer = 0;
+        GLuint arrayBuffer = 0;
+        GLuint elementArrayBuffer = 0;
+        GLuint texture = 0;
+
+        SGLPointer vertexPointer;
+        SGLPointer texCoordPointer;
+        SGLPointer colorPointer;
+    };
+
+    SGLContext *ctx() {
+        static SGLContext *context = new SGLContext();
+        return context;
+    }
+
+    // the texture attached to the bound framebuffer object, or the window framebuffer.
+    SGLTarget drawTarget() {
+        auto c = ctx();
+        SGLTarget target;
+        if (c->boundFramebuffer > 0) {
+            auto it = c->textures.find(c->framebuffers[c->boundFramebuffer]);
+            if (it != c->textures.end() && it->second.width > 0) {
+                target.pixels = it->second.pixels.data();
+                target.width = it->second.width;
+                target.height = it->second.height;
+            }
+            return target;
+        }
+        target.pixels = c->framebuffer.data();
+        target.width = c->width;
+        target.height = c->height;
+        return target;
+    }
+
+    GLfloat *currentMatrix() {
+        return (ctx()->matrixMode == GL_PROJECTION) ? ctx()->projection : ctx()->modelview;
+    }
+
+    void multiplyMatrix(GLfloat *m, const GLfloat *n) {
+        GLfloat r[16];
+        for (int c = 0; c < 4; c++) {
+            for (int row = 0; row < 4; row++) {
+                r[c * 4 + row] = m[0 * 4 + row] * n[c * 4 + 0] + m[1 * 4 + row] * n[c * 4 + 1] +
+                    m[2 * 4 + row] * n[c * 4 + 2] + m[3 * 4 + row] * n[c * 4 + 3];
+            }
+        }
+        memcpy(m, r, sizeof(GLfloat) * 16);
+    }
+
+    const unsigned char *resolvePointer(const SGLPointer &p) {
+        if (p.buffer == 0) return (const unsigned char *)p.pointer;
+        auto it = ctx()->buffers.find(p.buffer);
+        if (it == ctx()->buffers.end()) return nullptr;
+        return it->second.data.data() + (size_t)p.pointer;
+    }
+
+    void readAttribute(const SGLPointer &p, const unsigned char *base, int index, float *out) {
+        int size = (p.type == GL_FLOAT) ? sizeof(float) : sizeof(unsigned char);
+        int stride = p.stride > 0 ? p.stride : p.size * size;
+        const unsigned char *src = base + stride * index;
+        for (int i = 0; i < p.size; i++) {
+            if (p.type == GL_FLOAT) {
+                memcpy(&out[i], src + i * sizeof(float), sizeof(float));
+            } else {
+                out[i] = src[i] / 255.0f;
+            }
+        }
+    }
+
+    void fetchTexel(const SGLTexture &tex, int x, int y, float *out) {
+        x = max(0, min(tex.width - 1, x));
+        y = max(0, min(tex.height - 1, y));
+        const unsigned char *p = &tex.pixels[(y * tex.width + x) * 4];
+        for (int i = 0; i < 4; i++) {
+            out[i] = p[i] / 255.0f;
+        }
+    }
+
+    void sampleTexture(const SGLTexture &tex, float u, float v, float *out) {
+        if (tex.width == 0 || tex.height == 0) {
+            out[0] = out[1] = out[2] = out[3] = 1.0f;
+            return;
+        }
+        if (tex.magFilter == GL_NEAREST) {
+            fetchTexel(tex, (int)floorf(u * tex.width), (int)floorf(v * tex.height), out);
+            return;
+        }
+        float fx = u * tex.width - 0.5f;
+        float fy = v * tex.height - 0.5f;
+        int x0 = (int)floorf(fx);
+        int y0 = (int)floorf(fy);
+        float ax = fx - x0;
+        float ay = fy - y0;
+        float t00[4], t10[4], t01[4], t11[4];
+        fetchTexel(tex, x0, y0, t00);
+        fetchTexel(tex, x0 + 1, y0, t10);
+        fetchTexel(tex, x0, y0 + 1, t01);
+        fetchTexel(tex, x0 + 1, y0 + 1, t11);
+        for (int i = 0; i < 4; i++) {
+            float top = t00[i] + (t10[i] - t00[i]) * ax;
+            float bottom = t01[i] + (t11[i] - t01[i]) * ax;
+            out[i] = top + (bottom - top) * ay;
+        }
+    }
+
+    float blendFactor(GLenum factor, float srcAlpha) {
+        switch (factor) {
+            case GL_ZERO:
+                return 0;
+            case GL_SRC_ALPHA:
+                return srcAlpha;
+            case GL_ONE_MINUS_SRC_ALPHA:
+                return 1.0f - srcAlpha;
+            default:
+                return 1.0f;
+        }
+    }
+
+    void writePixel(const SGLTarget &target, int x, int y, const float *src) {
+        auto c = ctx();
+        unsigned char *dst = &target.pixels[(y * target.width + x) * 4];
+        if (c->enableBlend) {
+            float sf = blendFactor(c->blendSrc, src[3]);
+            float df = blendFactor(c->blendDst, src[3]);
+            float sfAlpha = blendFactor(c->blendSrcAlpha, src[3]);
+            float dfAlpha = blendFactor(c->blendDstAlpha, src[3]);
+            for (int i = 0; i < 4; i++) {
+                float v = (i < 3) ? src[i] * sf + (dst[i] / 255.0f) * df
+                                  : src[i] * sfAlpha + (dst[i] / 255.0f) * dfAlpha;
+                dst[i] = (unsigned char)(max(0.0f, min(1.0f, v)) * 255.0f + 0.5f);
+            }
+        } else {
+            for (int i = 0; i < 4; i++) {
+                dst[i] = (unsigned char)(max(0.0f, min(1.0f, src[i])) * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    // evaluated from the same end of the edge in both directions, so the triangles sharing an edge
+    // get exactly opposite values there and the fill rule alone decides which one covers a pixel on it.
+    float edge(const SGLVertex &a, const SGLVertex &b, float px, float py) {
+        if (b.x < a.x || (b.x == a.x && b.y < a.y)) {
+            return -((a.x - b.x) * (py - b.y) - (a.y - b.y) * (px - b.x));
+        }
+        return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+    }
+
+    // top-left fill rule, so shared edges of a strip are not blended twice.
+    bool isTopLeft(const SGLVertex &a, const SGLVertex &b) {
+        return (a.y == b.y && b.x < a.x) || (b.y < a.y);
+    }
+
+    void rasterizeTriangle(const SGLTarget &target, SGLVertex v0, SGLVertex v1, SGLVertex v2, const SGLTexture *tex) {
+        auto c = ctx();
+        float area = edge(v0, v1, v2.x, v2.y);
+        if (area == 0) return;
+        if (area < 0) {
+            swap(v1, v2);
+            area = -area;
+        }
+
+        int minX = max(0, (int)floorf(min(v0.x, min(v1.x, v2.x))));
+        int maxX = min(target.width - 1, (int)ceilf(max(v0.x, max(v1.x, v2.x))));
+        int minY = max(0, (int)floorf(min(v0.y, min(v1.y, v2.y))));
+        int maxY = min(target.height - 1, (int)ceilf(max(v0.y, max(v1.y, v2.y))));
+        if (c->enableScissor) {
+            minX = max(minX, c->scissor[0]);
+            minY = max(minY, c->scissor[1]);
+            maxX = min(maxX, c->scissor[0] + c->scissor[2] - 1);
+            maxY = min(maxY, c->scissor[1] + c->scissor[3] - 1);
+        }
+
+        bool tl0 = isTopLeft(v1, v2);
+        bool tl1 = isTopLeft(v2, v0);
+        bool tl2 = isTopLeft(v0, v1);
+
+        for (int y = minY; y <= maxY; y++) {
+            float py = y + 0.5f;
+            for (int x = minX; x <= maxX; x++) {
+                float px = x + 0.5f;
+                float w0 = edge(v1, v2, px, py);
+                float w1 = edge(v2, v0, px, py);
+                float w2 = edge(v0, v1, px, py);
+                if (w0 < 0 || w1 < 0 || w2 < 0) continue;
+                if ((w0 == 0 && !tl0) || (w1 == 0 && !tl1) || (w2 == 0 && !tl2)) continue;
+                w0 /= area;
+                w1 /= area;
+                w2 /= area;
+
+                float color[4];
+                for (int i = 0; i < 4; i++) {
+                    color[i] = v0.color[i] * w0 + v1.color[i] * w1 + v2.color[i] * w2;
+                }
+                if (tex) {
+                    float texel[4];
+                    sampleTexture(*tex, v0.u * w0 + v1.u * w1 + v2.u * w2, v0.v * w0 + v1.v * w1 + v2.v * w2, texel);
+                    for (int i = 0; i < 4; i++) {
+                        color[i] *= texel[i];
+                    }
+                }
+                writePixel(target, x, y, color);
+            }
+        }
+    }
+
+    int bytesPerPixel(GLenum format, GLenum type) {
+        if (type == GL_UNSIGNED_SHORT_4_4_4_4 || type == GL_UNSIGNED_SHORT_5_6_5) return 2;
+        switch (format) {
+            case GL_ALPHA: return 1;
+            case GL_LUMINANCE_ALPHA: return 2;
+            case GL_RGB: return 3;
+            default: return 4;
+        }
+    }
+
+    unsigned char expandBits(int value, int bits) {
+        int levels = (1 << bits) - 1;
+        return (unsigned char)((value * 255 + levels / 2) / levels);
+    }
+
+    // textures are stored as RGBA. alpha textures are white, so modulating keeps the fragment color as in GL.
+    void convertPixels(const unsigned char *src, GLenum format, GLenum type, int width, int height, int alignment,
+                       unsigned char *dst, int dstStride) {
+        int bpp = bytesPerPixel(format, type);
+        int srcStride = ((width * bpp + alignment - 1) / alignment) * alignment;
+        for (int y = 0; y < height; y++) {
+            const unsigned char *s = src + srcStride * y;
+            unsigned char *d = dst + dstStride * y;
+            for (int x = 0; x < width; x++, s += bpp, d += 4) {
+                unsigned short p = 0;
+                if (bpp == 2 && format != GL_LUMINANCE_ALPHA) {
+                    memcpy(&p, s, 2);
+                }
+                if (type == GL_UNSIGNED_SHORT_4_4_4_4) {
+                    d[0] = expandBits((p >> 12) & 0xf, 4);
+                    d[1] = expandBits((p >> 8) & 0xf, 4);
+                    d[2] = expandBits((p >> 4) & 0xf, 4);
+                    d[3] = expandBits(p & 0xf, 4);
+                } else if (type == GL_UNSIGNED_SHORT_5_6_5) {
+                    d[0] = expandBits((p >> 11) & 0x1f, 5);
+                    d[1] = expandBits((p >> 5) & 0x3f, 6);
+                    d[2] = expandBits(p & 0x1f, 5);
+                    d[3] = 255;
+                } else if (format == GL_ALPHA) {
+                    d[0] = d[1] = d[2] = 255;
+                    d[3] = s[0];
+                } else if (format == GL_LUMINANCE_ALPHA) {
+                    d[0] = d[1] = d[2] = s[0];
+                    d[3] = s[1];
+                } else {
+                    d[0] = s[0];
+                    d[1] = s[1];
+                    d[2] = s[2];
+                    d[3] = (bpp == 4) ? s[3] : 255;
+                }
+            }
+        }
+    }
+
+    SGLBuffer *boundBuffer(GLenum target) {
+        GLuint id = (target == GL_ELEMENT_ARRAY_BUFFER) ? ctx()->elementArrayBuffer : ctx()->arrayBuffer;
+        if (id == 0) return nullptr;
+        return &ctx()->buffers[id];
+    }
+}
+
+GLenum glGetError() {
+    return GL_NO_ERROR;
+}
+
+// the framebuffer object entry points are the only extension implemented
+const GLubyte *glGetString(GLenum name) {
+    if (name == GL_EXTENSIONS) return (const GLubyte *)"GL_EXT_framebuffer_object";
+    return nullptr;
+}
+
+void glHint(GLenum target, GLenum mode) {
+}
+
+static void setCapability(GLenum cap, bool enabled) {
+    switch (cap) {
+        case GL_TEXTURE_2D:
+            ctx()->enableTexture = enabled;
+            break;
+        case GL_BLEND:
+            ctx()->enableBlend = enabled;
+            break;
+        case GL_SCISSOR_TEST:
+            ctx()->enableScissor = enabled;
+            break;
+        default:
+            break;
+    }
+}
+
+void glEnable(GLenum cap) {
+    setCapability(cap, true);
+}
+
+void glDisable(GLenum cap) {
+    setCapability(cap, false);
+}
+
+static void setClientState(GLenum array, bool enabled) {
+    switch (array) {
+        case GL_VERTEX_ARRAY:
+            ctx()->enableVertexArray = enabled;
+            break;
+        case GL_TEXTURE_COORD_ARRAY:
+            ctx()->enableTexCoordArray = enabled;
+            break;
+        case GL_COLOR_ARRAY:
+            ctx()->enableColorArray = enabled;
+            break;
+        default:
+            break;
+    }
+}
+
+void glEnableClientState(GLenum array) {
+    setClientState(array, true);
+}
+
+void glDisableClientState(GLenum array) {
+    setClientState(array, false);
+}
+
+void glBlendFunc(GLenum sfactor, GLenum dfactor) {
+    glBlendFuncSeparate(sfactor, dfactor, sfactor, dfactor);
+}
+
+void glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+    auto c = ctx();
+    c->blendSrc = srcRGB;
+    c->blendDst = dstRGB;
+    c->blendSrcAlpha = srcAlpha;
+    c->blendDstAlpha = dstAlpha;
+}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    auto c = ctx();
+    c->viewport[0] = x;
+    c->viewport[1] = y;
+    c->viewport[2] = width;
+    c->viewport[3] = height;
+    if (c->boundFramebuffer > 0) return;
+    if (x + width != c->width || y + height != c->height) {
+        c->width = x + width;
+        c->height = y + height;
+        c->framebuffer.assign(c->width * c->height * 4, 0);
+        c->scissor[2] = c->width;
+        c->scissor[3] = c->height;
+    }
+}
+
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+    auto c = ctx();
+    c->scissor[0] = x;
+    c->scissor[1] = y;
+    c->scissor[2] = width;
+    c->scissor[3] = height;
+}
+
+void glClearColor(GLclampf r, GLclampf g, GLclampf b, GLclampf a) {
+    auto c = ctx();
+    c->clearColor[0] = r;
+    c->clearColor[1] = g;
+    c->clearColor[2] = b;
+    c->clearColor[3] = a;
+}
+
+void glClear(GLbitfield mask) {
+    auto c = ctx();
+    if ((mask & GL_COLOR_BUFFER_BIT) == 0) return;
+    unsigned char color[4];
+    for (int i = 0; i < 4; i++) {
+        color[i] = (unsigned char)(max(0.0f, min(1.0f, c->clearColor[i])) * 255.0f + 0.5f);
+    }
+    auto target = drawTarget();
+    int minX = 0, minY = 0, maxX = target.width, maxY = target.height;
+    if (c->enableScissor) {
+        minX = max(minX, c->scissor[0]);
+        minY = max(minY, c->scissor[1]);
+        maxX = min(maxX, c->scissor[0] + c->scissor[2]);
+        maxY = min(maxY, c->scissor[1] + c->scissor[3]);
+    }
+    for (int y = minY; y < maxY; y++) {
+        for (int x = minX; x < maxX; x++) {
+            memcpy(&target.pixels[(y * target.width + x) * 4], color, 4);
+        }
+    }
+}
+
+void glMatrixMode(GLenum mode) {
+    ctx()->matrixMode = mode;
+}
+
+void glLoadIdentity() {
+    GLfloat *m = currentMatrix();
+    memset(m, 0, sizeof(GLfloat) * 16);
+    m[0] = m[5] = m[10] = m[15] = 1.0f;
+}
+
+void glLoadMatrixf(const GLfloat *m) {
+    memcpy(currentMatrix(), m, sizeof(GLfloat) * 16);
+}
+
+void glOrtho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar) {
+    GLfloat o[16] = {0};
+    o[0] = (GLfloat)(2.0 / (right - left));
+    o[5] = (GLfloat)(2.0 / (top - bottom));
+    o[10] = (GLfloat)(-2.0 / (zFar - zNear));
+    o[12] = (GLfloat)(-(right + left) / (right - left));
+    o[13] = (GLfloat)(-(top + bottom) / (top - bottom));
+    o[14] = (GLfloat)(-(zFar + zNear) / (zFar - zNear));
+    o[15] = 1.0f;
+    multiplyMatrix(currentMatrix(), o);
+}
+
+void glGetFloatv(GLenum pname, GLfloat *params) {
+    switch (pname) {
+        case GL_MODELVIEW_MATRIX:
+            memcpy(params, ctx()->modelview, sizeof(GLfloat) * 16);
+            break;
+        case GL_CURRENT_COLOR:
+            memcpy(params, ctx()->color, sizeof(GLfloat) * 4);
+            break;
+        default:
+            break;
+    }
+}
+
+void glColor4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+    auto c = ctx();
+    c->color[0] = r;
+    c->color[1] = g;
+    c->color[2] = b;
+    c->color[3] = a;
+}
+
+void glGenBuffers(GLsizei n, GLuint *buffers) {
+    for (int i = 0; i < n; i++) {
+        buffers[i] = ctx()->nextId++;
+        ctx()->buffers[buffers[i]] = SGLBuffer();
+    }
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint *buffers) {
+    for (int i = 0; i < n; i++) {
+        ctx()->buffers.erase(buffers[i]);
+        if (ctx()->arrayBuffer == buffers[i]) ctx()->arrayBuffer = 0;
+        if (ctx()->elementArrayBuffer == buffers[i]) ctx()->elementArrayBuffer = 0;
+    }
+}
+
+void glBindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        ctx()->elementArrayBuffer = buffer;
+    } else {
+        ctx()->arrayBuffer = buffer;
+    }
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage) {
+    auto buffer = boundBuffer(target);
+    if (!buffer) return;
+    buffer->data.resize(size);
+    if (data) {
+        memcpy(buffer->data.data(), data, size);
+    }
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data) {
+    auto buffer = boundBuffer(target);
+    if (!buffer || offset + size > (GLintptr)buffer->data.size()) return;
+    memcpy(buffer->data.data() + offset, data, size);
+}
+
+static void setPointer(SGLPointer &p, GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
+    p.size = size;
+    p.type = type;
+    p.stride = stride;
+    p.buffer = ctx()->arrayBuffer;
+    p.pointer = pointer;
+}
+
+void glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
+    setPointer(ctx()->vertexPointer, size, type, stride, pointer);
+}
+
+void glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
+    setPointer(ctx()->texCoordPointer, size, type, stride, pointer);
+}
+
+void glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
+    setPointer(ctx()->colorPointer, size, type, stride, pointer);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices) {
+    auto c = ctx();
+    auto target = drawTarget();
+    if (!c->enableVertexArray || target.width == 0 || target.height == 0) return;
+
+    const unsigned char *idx = (const unsigned char *)indices;
+    if (c->elementArrayBuffer > 0) {
+        idx = c->buffers[c->elementArrayBuffer].data.data() + (size_t)indices;
+    }
+    const unsigned char *positions = resolvePointer(c->vertexPointer);
+    const unsigned char *texCoords = c->enableTexCoordArray ? resolvePointer(c->texCoordPointer) : nullptr;
+    const unsigned char *colors = c->enableColorArray ? resolvePointer(c->colorPointer) : nullptr;
+    if (!idx || !positions) return;
+
+    const SGLTexture *tex = nullptr;
+    if (c->enableTexture && texCoords) {
+        auto it = c->textures.find(c->texture);
+        if (it != c->textures.end()) tex = &it->second;
+    }
+
+    GLfloat mvp[16];
+    memcpy(mvp, c->projection, sizeof(GLfloat) * 16);
+    multiplyMatrix(mvp, c->modelview);
+
+    // reused between draws, so steady frames do not allocate
+    static vector<SGLVertex> vertices;
+    vertices.resize(count);
+    for (int i = 0; i < count; i++) {
+        int index = (type == GL_UNSIGNED_SHORT) ? ((const unsigned short *)idx)[i] : idx[i];
+        float p[4] = {0, 0, 0, 1.0f};
+        readAttribute(c->vertexPointer, positions, index, p);
+        float cx = mvp[0] * p[0] + mvp[4] * p[1] + mvp[8] * p[2] + mvp[12] * p[3];
+        float cy = mvp[1] * p[0] + mvp[5] * p[1] + mvp[9] * p[2] + mvp[13] * p[3];
+        float cw = mvp[3] * p[0] + mvp[7] * p[1] + mvp[11] * p[2] + mvp[15] * p[3];
+        auto &v = vertices[i];
+        v.x = (cx / cw + 1.0f) * 0.5f * c->viewport[2] + c->viewport[0];
+        v.y = (cy / cw + 1.0f) * 0.5f * c->viewport[3] + c->viewport[1];
+        float uv[4] = {0, 0, 0, 1.0f};
+        if (texCoords) {
+            readAttribute(c->texCoordPointer, texCoords, index, uv);
+        }
+        v.u = uv[0];
+        v.v = uv[1];
+        memcpy(v.color, c->color, sizeof(float) * 4);
+        if (colors) {
+            readAttribute(c->colorPointer, colors, index, v.color);
+        }
+    }
+
+    if (mode == GL_TRIANGLE_STRIP) {
+        for (int i = 2; i < count; i++) {
+            rasterizeTriangle(target, vertices[i - 2], vertices[i - 1], vertices[i], tex);
+        }
+    } else if (mode == GL_TRIANGLES) {
+        for (int i = 2; i < count; i += 3) {
+            rasterizeTriangle(target, vertices[i - 2], vertices[i - 1], vertices[i], tex);
+        }
+    }
+}
+
+void glGenTextures(GLsizei n, GLuint *textures) {
+    for (int i = 0; i < n; i++) {
+        textures[i] = ctx()->nextId++;
+        ctx()->textures[textures[i]] = SGLTexture();
+    }
+}
+
+void glDeleteTextures(GLsizei n, const GLuint *textures) {
+    for (int i = 0; i < n; i++) {
+        ctx()->textures.erase(textures[i]);
+        if (ctx()->texture == textures[i]) ctx()->texture = 0;
+    }
+}
+
+void glBindTexture(GLenum target, GLuint texture) {
+    ctx()->texture = texture;
+}
+
+void glPixelStorei(GLenum pname, GLint param) {
+    if (pname == GL_UNPACK_ALIGNMENT) {
+        ctx()->unpackAlignment = param;
+    }
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param) {
+    auto it = ctx()->textures.find(ctx()->texture);
+    if (it == ctx()->textures.end()) return;
+    if (pname == GL_TEXTURE_MIN_FILTER) {
+        it->second.minFilter = param;
+    } else if (pname == GL_TEXTURE_MAG_FILTER) {
+        it->second.magFilter = param;
+    }
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                  GLint border, GLenum format, GLenum type, const GLvoid *pixels) {
+    auto it = ctx()->textures.find(ctx()->texture);
+    if (it == ctx()->textures.end() || level != 0) return;
+    auto &tex = it->second;
+    tex.width = width;
+    tex.height = height;
+    tex.pixels.assign(width * height * 4, 0);
+    if (pixels) {
+        convertPixels((const unsigned char *)pixels, format, type, width, height, ctx()->unpackAlignment,
+                      tex.pixels.data(), width * 4);
+    }
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                     GLenum format, GLenum type, const GLvoid *pixels) {
+    auto it = ctx()->textures.find(ctx()->texture);
+    if (it == ctx()->textures.end() || level != 0 || !pixels) return;
+    auto &tex = it->second;
+    if (xoffset < 0 || yoffset < 0 || xoffset + width > tex.width || yoffset + height > tex.height) return;
+    convertPixels((const unsigned char *)pixels, format, type, width, height, ctx()->unpackAlignment,
+                  &tex.pixels[(yoffset * tex.width + xoffset) * 4], tex.width * 4);
+}
+
+void glGenFramebuffersEXT(GLsizei n, GLuint *framebuffers) {
+    for (int i = 0; i < n; i++) {
+        framebuffers[i] = ctx()->nextId++;
+        ctx()->framebuffers[framebuffers[i]] = 0;
+    }
+}
+
+void glDeleteFramebuffersEXT(GLsizei n, const GLuint *framebuffers) {
+    for (int i = 0; i < n; i++) {
+        ctx()->framebuffers.erase(framebuffers[i]);
+        if (ctx()->boundFramebuffer == framebuffers[i]) ctx()->boundFramebuffer = 0;
+    }
+}
+
+void glBindFramebufferEXT(GLenum target, GLuint framebuffer) {
+    ctx()->boundFramebuffer = framebuffer;
+}
+
+void glFramebufferTexture2DEXT(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
+    auto c = ctx();
+    if (c->boundFramebuffer == 0 || attachment != GL_COLOR_ATTACHMENT0_EXT) return;
+    c->framebuffers[c->boundFramebuffer] = texture;
+}
+
+GLenum glCheckFramebufferStatusEXT(GLenum target) {
+    auto c = ctx();
+    if (c->boundFramebuffer == 0) return GL_FRAMEBUFFER_COMPLETE_EXT;
+    auto it = c->textures.find(c->framebuffers[c->boundFramebuffer]);
+    if (it == c->textures.end() || it->second.width == 0) return GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT_EXT;
+    return GL_FRAMEBUFFER_COMPLETE_EXT;
+}
+
+// only level 0 is sampled
+void glGenerateMipmapEXT(GLenum target) {
+}
+
+// SoftwareGL
+
+const unsigned char *SoftwareGL::getFramebuffer(int *width, int *height) {
+    *width = ctx()->width;
+    *height = ctx()->height;
+    return ctx()->framebuffer.data();
+}
+
+void SoftwareGL::reset() {
+    auto c = ctx();
+    *c = SGLContext();
+}
+
+static unsigned int crc32(const unsigned char *data, size_t length, unsigned int crc = 0) {
+    static unsigned int table[256];
+    static bool initialized = false;
+    if (!initialized) {
+        for (unsigned int i = 0; i < 256; i++) {
+            unsigned int c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        initialized = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void appendUInt32(vector<unsigned char> &out, unsigned int v) {
+    out.push_back((v >> 24) & 0xFF);
+    out.push_back((v >> 16) & 0xFF);
+    out.push_back((v >> 8) & 0xFF);
+    out.push_back(v & 0xFF);
+}
+
+static void appendChunk(vector<unsigned char> &out, const char *type, const vector<unsigned char> &data) {
+    appendUInt32(out, (unsigned int)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendUInt32(out, crc32(&out[start], out.size() - start));
+}
+
+// writes an uncompressed (stored deflate blocks) png, so no zlib is required.
+bool SoftwareGL::writePNG(const std::string &filepath) {
+    auto c = ctx();
+    if (c->width == 0 || c->height == 0) return false;
+
+    vector<unsigned char> raw;
+    raw.reserve((c->width * 4 + 1) * c->height);
+    for (int y = c->height - 1; y >= 0; y--) {
+        raw.push_back(0);
+        const unsigned char *row = &c->framebuffer[y * c->width * 4];
+        raw.insert(raw.end(), row, row + c->width * 4);
+    }
+
+    vector<unsigned char> idat = {0x78, 0x01};
+    unsigned int a = 1, b = 0;
+    for (size_t i = 0; i < raw.size(); i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+        size_t len = min((size_t)65535, raw.size() - pos);
+        bool final = (pos + len == raw.size());
+        idat.push_back(final ? 1 : 0);
+        idat.push_back(len & 0xFF);
+        idat.push_back((len >> 8) & 0xFF);
+        idat.push_back(~len & 0xFF);
+        idat.push_back((~len >> 8) & 0xFF);
+        idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+        if (final) break;
+    }
+    appendUInt32(idat, (b << 16) | a);
+
+    vector<unsigned char> ihdr;
+    appendUInt32(ihdr, c->width);
+    appendUInt32(ihdr, c->height);
+    ihdr.push_back(8);  // bit depth
+    ihdr.push_back(6);  // rgba
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+
+    const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    vector<unsigned char> png(signature, signature + 8);
+    appendChunk(png, "IHDR", ihdr);
+    appendChunk(png, "IDAT", idat);
+    appendChunk(png, "IEND", vector<unsigned char>());
+
+    FILE *fp = fopen(filepath.c_str(), "wb");
+    if (!fp) return false;
+    size_t written = fwrite(png.data(), 1, png.size(), fp);
+    fclose(fp);
+    return written == png.size();
+}
+
+#endif /* MOG_SOFTWARE_RENDERER */
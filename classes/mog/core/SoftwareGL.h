@@ -0,0 +1,146 @@
+#ifndef SoftwareGL_h
+#define SoftwareGL_h
+
+#ifdef MOG_SOFTWARE_RENDERER
+
+#include <string>
+#include <stddef.h>
+
+// subset of the OpenGL ES 1.x api used by the engine, emulated on the cpu.
+// selected at build time with MOG_SOFTWARE_RENDERER.
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef void GLvoid;
+typedef int GLint;
+typedef unsigned char GLubyte;
+typedef unsigned int GLuint;
+typedef int GLsizei;
+typedef float GLfloat;
+typedef float GLclampf;
+typedef double GLdouble;
+typedef ptrdiff_t GLintptr;
+typedef ptrdiff_t GLsizeiptr;
+
+#define GL_NO_ERROR 0
+#define GL_ZERO 0
+#define GL_ONE 1
+#define GL_TRIANGLES 0x0004
+#define GL_TRIANGLE_STRIP 0x0005
+#define GL_SRC_ALPHA 0x0302
+#define GL_ONE_MINUS_SRC_ALPHA 0x0303
+#define GL_CULL_FACE 0x0B44
+#define GL_LIGHTING 0x0B50
+#define GL_DEPTH_TEST 0x0B71
+#define GL_MODELVIEW_MATRIX 0x0BA6
+#define GL_DITHER 0x0BD0
+#define GL_BLEND 0x0BE2
+#define GL_SCISSOR_TEST 0x0C11
+#define GL_CURRENT_COLOR 0x0B00
+#define GL_PERSPECTIVE_CORRECTION_HINT 0x0C50
+#define GL_UNPACK_ALIGNMENT 0x0CF5
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_NICEST 0x1102
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_UNSIGNED_SHORT 0x1403
+#define GL_FLOAT 0x1406
+#define GL_MODELVIEW 0x1700
+#define GL_PROJECTION 0x1701
+#define GL_ALPHA 0x1906
+#define GL_RGB 0x1907
+#define GL_RGBA 0x1908
+#define GL_LUMINANCE_ALPHA 0x190A
+#define GL_EXTENSIONS 0x1F03
+#define GL_NEAREST 0x2600
+#define GL_LINEAR 0x2601
+#define GL_LINEAR_MIPMAP_LINEAR 0x2703
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_UNSIGNED_SHORT_4_4_4_4 0x8033
+#define GL_ALPHA8 0x803C
+#define GL_LUMINANCE8_ALPHA8 0x8045
+#define GL_RGB5 0x8050
+#define GL_RGB8 0x8051
+#define GL_RGBA4 0x8056
+#define GL_RGBA8 0x8058
+#define GL_CLAMP_TO_EDGE 0x812F
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#define GL_UNSIGNED_SHORT_5_6_5 0x8363
+#define GL_VERTEX_ARRAY 0x8074
+#define GL_COLOR_ARRAY 0x8076
+#define GL_TEXTURE_COORD_ARRAY 0x8078
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#define GL_DYNAMIC_DRAW 0x88E8
+#define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_FRAMEBUFFER_COMPLETE_EXT 0x8CD5
+#define GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT_EXT 0x8CD6
+#define GL_COLOR_ATTACHMENT0_EXT 0x8CE0
+#define GL_FRAMEBUFFER_EXT 0x8D40
+
+GLenum glGetError();
+const GLubyte *glGetString(GLenum name);
+void glHint(GLenum target, GLenum mode);
+void glEnable(GLenum cap);
+void glDisable(GLenum cap);
+void glEnableClientState(GLenum array);
+void glDisableClientState(GLenum array);
+void glBlendFunc(GLenum sfactor, GLenum dfactor);
+void glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+void glClearColor(GLclampf r, GLclampf g, GLclampf b, GLclampf a);
+void glClear(GLbitfield mask);
+
+void glMatrixMode(GLenum mode);
+void glLoadIdentity();
+void glLoadMatrixf(const GLfloat *m);
+void glOrtho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar);
+void glGetFloatv(GLenum pname, GLfloat *params);
+void glColor4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+void glGenBuffers(GLsizei n, GLuint *buffers);
+void glDeleteBuffers(GLsizei n, const GLuint *buffers);
+void glBindBuffer(GLenum target, GLuint buffer);
+void glBufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage);
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data);
+
+void glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer);
+void glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer);
+void glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer);
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices);
+
+void glGenTextures(GLsizei n, GLuint *textures);
+void glDeleteTextures(GLsizei n, const GLuint *textures);
+void glBindTexture(GLenum target, GLuint texture);
+void glPixelStorei(GLenum pname, GLint param);
+void glTexParameteri(GLenum target, GLenum pname, GLint param);
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                  GLint border, GLenum format, GLenum type, const GLvoid *pixels);
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                     GLenum format, GLenum type, const GLvoid *pixels);
+
+void glGenFramebuffersEXT(GLsizei n, GLuint *framebuffers);
+void glDeleteFramebuffersEXT(GLsizei n, const GLuint *framebuffers);
+void glBindFramebufferEXT(GLenum target, GLuint framebuffer);
+void glFramebufferTexture2DEXT(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+GLenum glCheckFramebufferStatusEXT(GLenum target);
+void glGenerateMipmapEXT(GLenum target);
+
+namespace mog {
+    class SoftwareGL {
+    public:
+        // rgba framebuffer, rows are stored bottom-up like glReadPixels.
+        static const unsigned char *getFramebuffer(int *width, int *height);
+        static bool writePNG(const std::string &filepath);
+        static void reset();
+    };
+}
+
+#endif /* MOG_SOFTWARE_RENDERER */
+
+#endif /* SoftwareGL_h */
@@ -2,8 +2,14 @@
 #include "mog/core/Texture2D.h"
 #include "mog/core/Texture2DNative.h"
 #include "mog/core/FileUtils.h"
+#include "mog/core/RenderDevice.h"
+#include "mog/core/TextureLoader.h"
+#include "mog/core/MogStats.h"
+#include "mog/core/TextureContainer.h"
+#include "mog/core/AssetManifest.h"
 #include <stdlib.h>
 #include <vector>
+#include <math.h>
 #define STB_IMAGE_IMPLEMENTATION
 #include "mog/libs/stb_image.h"
 
@@ -15,12 +21,51 @@ const Density Density::x2_0 = Density(2);
 const Density Density::x3_0 = Density(3);
 const Density Density::x4_0 = Density(4);
 
+unordered_map<string, TextureType> Texture2D::textureTypes;
+function<TextureType(Texture2D *texture)> Texture2D::textureTypeRule;
+mutex Texture2D::textureTypeMutex;
+vector<weak_ptr<Texture2D>> Texture2D::uploadedTextures;
+
+// thresholds of the 4x4 ordered dithering
+static const int bayerMatrix[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+static int quantize(unsigned char value, int bits, float threshold) {
+    int levels = (1 << bits) - 1;
+    int q = (int)floorf(value * levels / 255.0f + threshold + 0.5f);
+    return max(0, min(levels, q));
+}
+
+static unsigned char expand(int value, int bits) {
+    int levels = (1 << bits) - 1;
+    return (unsigned char)((value * 255 + levels / 2) / levels);
+}
+
 shared_ptr<Texture2D> Texture2D::createWithAsset(string filename) {
     auto tex2d = make_shared<Texture2D>();
     tex2d->loadTextureAsset(filename);
     return tex2d;
 }
 
+shared_ptr<Texture2D> Texture2D::createWithAsset(string filename, Density density) {
+    auto tex2d = make_shared<Texture2D>();
+    tex2d->filename = filename;
+    if (tex2d->loadAssetPath(density.directory + "/" + filename, density)) {
+        tex2d->source = Source::Asset;
+    } else {
+        LOGE("Asset not found: %s/%s", density.directory.c_str(), filename.c_str());
+    }
+    return tex2d;
+}
+
+void Texture2D::createWithAssetAsync(string filename, function<void(const shared_ptr<Texture2D> &texture)> callback) {
+    TextureLoader::getInstance()->loadAsset(filename, callback);
+}
+
 shared_ptr<Texture2D> Texture2D::createWithFile(string filepath, Density density) {
     auto tex2d = make_shared<Texture2D>();
     tex2d->loadTextureFile(filepath, density);
@@ -57,62 +102,264 @@ shared_ptr<Texture2D> Texture2D::createWithRGBA(unsigned char *data, int width,
     return tex2d;
 }
 
+void Texture2D::setTextureType(string filename, TextureType textureType) {
+    lock_guard<mutex> lock(Texture2D::textureTypeMutex);
+    Texture2D::textureTypes[filename] = textureType;
+}
+
+void Texture2D::setTextureTypeRule(function<TextureType(Texture2D *texture)> rule) {
+    lock_guard<mutex> lock(Texture2D::textureTypeMutex);
+    Texture2D::textureTypeRule = rule;
+}
+
+int Texture2D::getBytesPerPixel(TextureType textureType) {
+    switch (textureType) {
+        case TextureType::RGBA:
+            return 4;
+        case TextureType::RGB:
+            return 3;
+        case TextureType::RGBA4444:
+        case TextureType::RGB565:
+        case TextureType::LA88:
+            return 2;
+        case TextureType::A8:
+            return 1;
+    }
+    return 4;
+}
+
+void Texture2D::releaseUploadedData() {
+    for (const auto &uploadedTexture : Texture2D::uploadedTextures) {
+        if (auto texture = uploadedTexture.lock()) {
+            texture->releaseData();
+        }
+    }
+    Texture2D::uploadedTextures.clear();
+}
+
+void Texture2D::readPixel(TextureType textureType, const unsigned char *src, unsigned char *rgba) {
+    unsigned short p = 0;
+    switch (textureType) {
+        case TextureType::RGBA:
+            memcpy(rgba, src, 4);
+            break;
+        case TextureType::RGB:
+            memcpy(rgba, src, 3);
+            rgba[3] = 255;
+            break;
+        case TextureType::RGBA4444:
+            memcpy(&p, src, 2);
+            rgba[0] = expand((p >> 12) & 0xf, 4);
+            rgba[1] = expand((p >> 8) & 0xf, 4);
+            rgba[2] = expand((p >> 4) & 0xf, 4);
+            rgba[3] = expand(p & 0xf, 4);
+            break;
+        case TextureType::RGB565:
+            memcpy(&p, src, 2);
+            rgba[0] = expand((p >> 11) & 0x1f, 5);
+            rgba[1] = expand((p >> 5) & 0x3f, 6);
+            rgba[2] = expand(p & 0x1f, 5);
+            rgba[3] = 255;
+            break;
+        case TextureType::A8:
+            rgba[0] = rgba[1] = rgba[2] = 255;
+            rgba[3] = src[0];
+            break;
+        case TextureType::LA88:
+            rgba[0] = rgba[1] = rgba[2] = src[0];
+            rgba[3] = src[1];
+            break;
+    }
+}
+
+void Texture2D::writePixel(TextureType textureType, const unsigned char *rgba, unsigned char *dst, int x, int y, bool dither) {
+    float threshold = dither ? (bayerMatrix[y & 3][x & 3] + 0.5f) / 16.0f - 0.5f : 0;
+    unsigned short p = 0;
+    switch (textureType) {
+        case TextureType::RGBA:
+            memcpy(dst, rgba, 4);
+            break;
+        case TextureType::RGB:
+            memcpy(dst, rgba, 3);
+            break;
+        case TextureType::RGBA4444:
+            p = (quantize(rgba[0], 4, threshold) << 12) | (quantize(rgba[1], 4, threshold) << 8) |
+                (quantize(rgba[2], 4, threshold) << 4) | quantize(rgba[3], 4, threshold);
+            memcpy(dst, &p, 2);
+            break;
+        case TextureType::RGB565:
+            p = (quantize(rgba[0], 5, threshold) << 11) | (quantize(rgba[1], 6, threshold) << 5) | quantize(rgba[2], 5, threshold);
+            memcpy(dst, &p, 2);
+            break;
+        case TextureType::A8:
+            dst[0] = rgba[3];
+            break;
+        case TextureType::LA88:
+            dst[0] = (unsigned char)((rgba[0] * 77 + rgba[1] * 150 + rgba[2] * 29 + 128) >> 8);
+            dst[1] = rgba[3];
+            break;
+    }
+}
+
 Texture2D::Texture2D() {
 }
 
 Texture2D::~Texture2D() {
-    free(this->data);
+    this->freeData();
+    MogStats::textureBytes -= this->uploadedBytes;
+    MogStats::textureRGBABytes -= this->uploadedRGBABytes;
     if (this->textureId > 0) {
-        glDeleteTextures(1, &this->textureId);
+        RenderDevice::getInstance()->deleteTexture(this->textureId);
     }
 }
 
+// the image is resolved first, so that a container of another density never shadows it.
 void Texture2D::loadTextureAsset(string filename) {
-    unsigned char *buffer = nullptr;
-    int len = 0;
+    this->filename = filename;
+    string path;
     Density den = Density::x1_0;
-    
-    if (!this->readBytesAsset(filename, &buffer, &len, &den)) {
+    bool found = this->findAssetPath(filename, &path, &den) ||
+        // the container may be shipped without the image
+        (!TextureContainer::isContainer(filename) && this->findAssetPath(TextureContainer::getContainerName(filename), &path, &den));
+    if (!found || !this->loadAssetPath(path, den)) {
         LOGE("Asset not found: %s", filename.c_str());
+        return;
     }
+    this->source = Source::Asset;
+}
+
+// a container converted from the image is preferred over decoding it, only when it is next to the image.
+// a missing container is not opened.
+bool Texture2D::loadAssetPath(string path, Density density) {
+    this->assetPath = path;
+    this->density = density;
+    bool isContainer = TextureContainer::isContainer(path);
+    string containerPath = isContainer ? path : TextureContainer::getContainerName(path);
+    auto manifest = AssetManifest::getInstance();
+    bool hasContainer = manifest->isBuilt() ? manifest->hasPath(containerPath) : FileUtils::existAsset(containerPath);
+    if (hasContainer && this->loadContainerAsset(containerPath)) {
+        return true;
+    }
+    if (isContainer) return false;
     
-    this->filename = filename;
-    this->density = den;
+    unsigned char *buffer = nullptr;
+    int len = 0;
+    if (!FileUtils::readBytesAsset(path, &buffer, &len)) return false;
     this->loadImageFromBuffer(buffer, len);
     safe_free(buffer);
+    this->applyTextureType();
+    return this->data != nullptr;
 }
 
 void Texture2D::loadTextureFile(string filepath, Density density) {
+    this->filename = filepath;
     this->density = density;
+    if (TextureContainer::isContainer(filepath)) {
+        auto mappedFile = FileUtils::mapFile(filepath);
+        unsigned char *buffer = nullptr;
+        int len = 0;
+        if ((mappedFile || FileUtils::readDataFromFile(filepath, &buffer, &len)) && this->loadContainer(mappedFile, buffer, len)) {
+            this->source = Source::File;
+        }
+        return;
+    }
     unsigned char *buffer = nullptr;
     int len = 0;
     FileUtils::readDataFromFile(filepath, &buffer, &len);
     this->loadImageFromBuffer(buffer, len);
     safe_free(buffer);
+    if (this->data) {
+        this->source = Source::File;
+    }
+    this->applyTextureType();
 }
 
-bool Texture2D::readBytesAsset(string filename, unsigned char **data, int *len, Density *density) {
-    Density den = Density::getCurrent();
-    if (FileUtils::readBytesAsset(den.directory + "/" + filename, data, len)) {
-        *density = den;
-        return true;
-    }
-    for (int i = den.idx + 1; i < Density::allDensities.size(); i++) {
-        den = Density::allDensities[i];
-        if (FileUtils::readBytesAsset(den.directory + "/" + filename, data, len)) {
-            *density = den;
-            return true;
+void Texture2D::applyTextureType() {
+    if (this->data == nullptr) return;
+    
+    TextureType textureType = this->textureType;
+    function<TextureType(Texture2D *texture)> rule = nullptr;
+    {
+        lock_guard<mutex> lock(Texture2D::textureTypeMutex);
+        auto it = Texture2D::textureTypes.find(this->filename);
+        if (it != Texture2D::textureTypes.end()) {
+            textureType = it->second;
+        } else {
+            rule = Texture2D::textureTypeRule;
         }
     }
-    for (int i = den.idx - 1; i >= 0; i--) {
-        den = Density::allDensities[i];
-        if (FileUtils::readBytesAsset(den.directory + "/" + filename, data, len)) {
+    if (rule) {
+        textureType = rule(this);
+    }
+    this->convert(textureType);
+}
+
+bool Texture2D::loadContainerAsset(string path) {
+    auto mappedFile = FileUtils::mapAsset(path);
+    unsigned char *buffer = nullptr;
+    int len = 0;
+    if (!mappedFile && !FileUtils::readBytesAsset(path, &buffer, &len)) return false;
+    return this->loadContainer(mappedFile, buffer, len);
+}
+
+// the pixels are used in place from the mapping. a container that could only be read keeps its buffer.
+// the type was chosen when the container was written, the type rules are not applied.
+bool Texture2D::loadContainer(const shared_ptr<MappedFile> &mappedFile, unsigned char *buffer, int len) {
+    const unsigned char *data = mappedFile ? mappedFile->data : buffer;
+    int length = mappedFile ? mappedFile->length : len;
+    TextureContainer::Header header;
+    if (!TextureContainer::readHeader(data, length, &header)) {
+        LOGE("Texture2D::loadContainer: This container is not supported.");
+        LOGE(filename.c_str());
+        safe_free(buffer);
+        return false;
+    }
+    
+    this->freeData();
+    if (mappedFile) {
+        this->mappedFile = mappedFile;
+        this->data = (GLubyte *)&mappedFile->data[header.dataOffset];
+    } else {
+        memmove(buffer, &buffer[header.dataOffset], header.dataLength);
+        this->data = buffer;
+    }
+    int bytesPerPixel = Texture2D::getBytesPerPixel(header.textureType);
+    this->textureType = header.textureType;
+    this->width = header.width;
+    this->height = header.height;
+    this->bitsPerPixel = bytesPerPixel;
+    this->dataLength = header.width * header.height * bytesPerPixel;
+    this->dataLevels = header.levels;
+    this->premultipliedAlpha = header.premultipliedAlpha;
+    if (header.levels > 1) {
+        this->mipmap = true;
+        this->mipmapLevels = header.levels - 1;
+    }
+    return true;
+}
+
+// the file is looked up in the manifest. without a manifest, the current density is tried first,
+// then the higher ones, the lower ones and the root of the assets.
+bool Texture2D::findAssetPath(string filename, string *path, Density *density) {
+    auto manifest = AssetManifest::getInstance();
+    if (manifest->isBuilt()) {
+        auto entry = manifest->find(filename);
+        if (entry == nullptr) return false;
+        *path = entry->path;
+        *density = entry->density;
+        return true;
+    }
+    
+    for (const auto &den : AssetManifest::getDensityOrder()) {
+        if (FileUtils::existAsset(den.directory + "/" + filename)) {
+            *path = den.directory + "/" + filename;
             *density = den;
             return true;
         }
     }
-    if (FileUtils::readBytesAsset(filename, data, len)) {
-        *density = den;
+    if (FileUtils::existAsset(filename)) {
+        *path = filename;
+        *density = Density::x1_0;
         return true;
     }
     return false;
@@ -124,50 +371,133 @@ void Texture2D::loadFontTexture(string text, float fontSize, string fontFilename
     this->density = den;
 }
 
-GLenum toGLFormat(TextureType textureType) {
-    GLenum format = GL_RGBA;
-    switch (textureType){
-        case TextureType::RGBA:
-            format = GL_RGBA;
-            break;
-            
-        case TextureType::RGB:
-            format = GL_RGB;
-            break;
-    }
-    return format;
-}
-
+// the pixels are decoded again when the texture is uploaded after they have been released, e.g. on a context rebuild.
+// they are released at the end of the frame, so an atlas packing the texture in this frame does not decode it again.
 void Texture2D::bindTexture() {
+    auto &device = RenderDevice::getInstance();
     if (this->textureId == 0) {
-        glGenTextures(1, &this->textureId);
+        this->textureId = device->createTexture();
+    }
+    this->loadData();
+    device->uploadTexture(this->textureId, this->textureType, this->width, this->height, this->data);
+    if (this->mipmap) {
+        this->uploadMipmap();
     }
     
-    glBindTexture(GL_TEXTURE_2D, this->textureId);
-    
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    
-    GLenum format = toGLFormat(this->textureType);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->width, this->height, 0, format, GL_UNSIGNED_BYTE, this->data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    long bytes = (long)this->width * this->height * device->getTextureBytesPerPixel(this->textureType);
+    long rgbaBytes = (long)this->width * this->height * 4;
+    // the reduced levels add about a third
+    if (this->mipmap) {
+        bytes += bytes / 3;
+        rgbaBytes += rgbaBytes / 3;
+    }
+    MogStats::textureBytes += bytes - this->uploadedBytes;
+    MogStats::textureRGBABytes += rgbaBytes - this->uploadedRGBABytes;
+    this->uploadedBytes = bytes;
+    this->uploadedRGBABytes = rgbaBytes;
+    if (!this->retainData && this->source != Source::Memory) {
+        Texture2D::uploadedTextures.emplace_back(this->shared_from_this());
+    }
 }
 
 void Texture2D::bindTextureSub(GLubyte* data, int x, int y, int width, int height) {
-    glBindTexture(GL_TEXTURE_2D, this->textureId);
+    RenderDevice::getInstance()->uploadTextureSub(this->textureId, this->textureType, x, y, width, height, data);
+}
+
+// levels stored in a container are uploaded as they are. otherwise the device generates them when it can,
+// or they are box filtered on the CPU.
+void Texture2D::uploadMipmap() {
+    if (this->textureId == 0) return;
+    auto &device = RenderDevice::getInstance();
+    int maxLevel = 0;
+    for (int size = max(this->width, this->height); size > 1; size /= 2) {
+        maxLevel++;
+    }
+    if (this->mipmapLevels > 0) {
+        maxLevel = min(maxLevel, this->mipmapLevels);
+    }
+    if (this->data && this->dataLevels > 1) {
+        maxLevel = min(maxLevel, this->dataLevels - 1);
+        device->setTextureMaxLevel(this->textureId, maxLevel);
+        int bytesPerPixel = Texture2D::getBytesPerPixel(this->textureType);
+        int offset = this->width * this->height * bytesPerPixel;
+        for (int l = 1; l <= maxLevel; l++) {
+            int w = max(1, this->width >> l);
+            int h = max(1, this->height >> l);
+            device->uploadTextureLevel(this->textureId, this->textureType, l, w, h, &this->data[offset]);
+            offset += w * h * bytesPerPixel;
+        }
+        return;
+    }
+    device->setTextureMaxLevel(this->textureId, maxLevel);
+    if (maxLevel == 0 || device->generateMipmap(this->textureId)) return;
     
-    GLenum format = toGLFormat(this->textureType);
+    auto levels = this->createMipmapLevels(maxLevel);
+    for (int l = 1; l <= levels.size(); l++) {
+        device->uploadTextureLevel(this->textureId, this->textureType, l, max(1, this->width >> l), max(1, this->height >> l), levels[l - 1].data());
+    }
+}
+
+// each level is a 2x2 box filter of the previous one. straight colors are weighted by alpha,
+// so transparent pixels do not darken the edges.
+vector<vector<unsigned char>> Texture2D::createMipmapLevels(int levels) {
+    vector<vector<unsigned char>> mipmapLevels;
+    if (!this->loadData()) return mipmapLevels;
+    int maxLevel = 0;
+    for (int size = max(this->width, this->height); size > 1; size /= 2) {
+        maxLevel++;
+    }
+    if (levels > 0) {
+        maxLevel = min(maxLevel, levels);
+    }
     
-    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, GL_UNSIGNED_BYTE, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    int bytesPerPixel = Texture2D::getBytesPerPixel(this->textureType);
+    int width = this->width;
+    int height = this->height;
+    vector<unsigned char> src(width * height * 4);
+    for (int i = 0; i < width * height; i++) {
+        Texture2D::readPixel(this->textureType, &this->data[i * bytesPerPixel], &src[i * 4]);
+    }
+    vector<unsigned char> dst;
+    for (int l = 1; l <= maxLevel; l++) {
+        int w = max(1, width / 2);
+        int h = max(1, height / 2);
+        dst.resize(w * h * 4);
+        mipmapLevels.emplace_back(w * h * bytesPerPixel);
+        auto &level = mipmapLevels.back();
+        for (int y = 0; y < h; y++) {
+            int y0 = min(y * 2, height - 1);
+            int y1 = min(y * 2 + 1, height - 1);
+            for (int x = 0; x < w; x++) {
+                int x0 = min(x * 2, width - 1);
+                int x1 = min(x * 2 + 1, width - 1);
+                const unsigned char *p[4] = {
+                    &src[(y0 * width + x0) * 4], &src[(y0 * width + x1) * 4],
+                    &src[(y1 * width + x0) * 4], &src[(y1 * width + x1) * 4],
+                };
+                int alpha = p[0][3] + p[1][3] + p[2][3] + p[3][3];
+                unsigned char *d = &dst[(y * w + x) * 4];
+                for (int c = 0; c < 3; c++) {
+                    if (alpha > 0 && !this->premultipliedAlpha) {
+                        d[c] = (unsigned char)((p[0][c] * p[0][3] + p[1][c] * p[1][3] + p[2][c] * p[2][3] + p[3][c] * p[3][3] + alpha / 2) / alpha);
+                    } else {
+                        d[c] = (unsigned char)((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) / 4);
+                    }
+                }
+                d[3] = (unsigned char)((alpha + 2) / 4);
+                Texture2D::writePixel(this->textureType, d, &level[(y * w + x) * bytesPerPixel], x, y, false);
+            }
+        }
+        src.swap(dst);
+        width = w;
+        height = h;
+    }
+    return mipmapLevels;
 }
 
+// compact types are filled as RGBA and converted
 void Texture2D::loadColorTexture(TextureType textureType, const Color &color, int width, int height, Density density) {
-    this->textureType = textureType;
+    this->textureType = (textureType == TextureType::RGB) ? TextureType::RGB : TextureType::RGBA;
     this->width = width;
     this->height = height;
     this->density = density;
@@ -193,6 +523,7 @@ void Texture2D::loadColorTexture(TextureType textureType, const Color &color, in
             this->data[i * 4 + 3] = (int)(color.a * 255.0f);
         }
     }
+    this->convert(textureType, false);
 }
 
 void Texture2D::loadImageFromBuffer(unsigned char *buffer, int len) {
@@ -223,3 +554,73 @@ void Texture2D::loadImageFromBuffer(unsigned char *buffer, int len) {
     this->bitsPerPixel = n;
     this->dataLength = x * y * n;
 }
+
+// converts the pixels in place. reducing the precision of the channels is dithered unless disabled.
+void Texture2D::convert(TextureType textureType, bool dither) {
+    if (this->textureType == textureType) return;
+    int bytesPerPixel = Texture2D::getBytesPerPixel(textureType);
+    if (this->data == nullptr) {
+        this->textureType = textureType;
+        this->bitsPerPixel = bytesPerPixel;
+        return;
+    }
+    
+    int srcBytesPerPixel = Texture2D::getBytesPerPixel(this->textureType);
+    GLubyte *data = (GLubyte *)malloc(this->width * this->height * bytesPerPixel);
+    unsigned char rgba[4];
+    for (int y = 0; y < this->height; y++) {
+        for (int x = 0; x < this->width; x++) {
+            int i = y * this->width + x;
+            Texture2D::readPixel(this->textureType, &this->data[i * srcBytesPerPixel], rgba);
+            Texture2D::writePixel(textureType, rgba, &data[i * bytesPerPixel], x, y, dither);
+        }
+    }
+    this->freeData();
+    this->data = data;
+    this->textureType = textureType;
+    this->bitsPerPixel = bytesPerPixel;
+    this->dataLength = this->width * this->height * bytesPerPixel;
+}
+
+bool Texture2D::isOpaque() {
+    if (this->textureType == TextureType::RGB || this->textureType == TextureType::RGB565) return true;
+    if (this->data == nullptr) return false;
+    
+    int bytesPerPixel = Texture2D::getBytesPerPixel(this->textureType);
+    unsigned char rgba[4];
+    for (int i = 0; i < this->width * this->height; i++) {
+        Texture2D::readPixel(this->textureType, &this->data[i * bytesPerPixel], rgba);
+        if (rgba[3] < 255) return false;
+    }
+    return true;
+}
+
+// the type is kept even when it was converted after the load.
+bool Texture2D::loadData() {
+    if (this->data) return true;
+    if (this->source == Source::Memory) return false;
+    
+    auto textureType = this->textureType;
+    if (this->source == Source::Asset) {
+        this->loadAssetPath(this->assetPath, this->density);
+    } else {
+        this->loadTextureFile(this->filename, this->density);
+    }
+    this->convert(textureType);
+    return this->data != nullptr;
+}
+
+void Texture2D::releaseData() {
+    if (this->retainData || this->atlasHoldCount > 0 || this->source == Source::Memory) return;
+    this->freeData();
+}
+
+void Texture2D::freeData() {
+    if (this->mappedFile) {
+        this->mappedFile = nullptr;
+        this->data = nullptr;
+    } else {
+        safe_free(this->data);
+    }
+    this->dataLevels = 1;
+}
@@ -5,9 +5,12 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <mutex>
 #include "mog/core/opengl.h"
 #include "mog/core/plain_objects.h"
 #include "mog/core/Density.h"
+#include "mog/core/FileUtils.h"
 
 using namespace std;
 
@@ -16,11 +19,22 @@ namespace mog {
     enum class TextureType {
         RGBA,
         RGB,
+        // 16 bits per pixel, 4 bits per channel
+        RGBA4444,
+        // 16 bits per pixel, opaque
+        RGB565,
+        // alpha only, the color comes from the vertex or tint color
+        A8,
+        // luminance and alpha
+        LA88,
     };
     
     
     class Texture2D : public enable_shared_from_this<Texture2D> {
     public:
+        friend class TextureLoader;
+        friend class TextureAtlas;
+        
         GLuint textureId = 0;
         string filename;
         TextureType textureType = TextureType::RGBA;
@@ -30,25 +44,93 @@ namespace mog {
         int dataLength = 0;
         int bitsPerPixel = 0;
         bool isFlip = false;
+        // a page of an atlas baked offline. batching groups draw it as it is instead of packing it again.
+        bool isAtlasPage = false;
+        // the pixels are released at the end of the frame they are uploaded in, when they can be decoded again
+        // from the asset or file and no atlas holds them. set this to keep them, e.g. for textures read on the CPU every frame.
+        bool retainData = false;
+        // the mip chain is uploaded with the texture and sampled with trilinear filtering, for textures drawn scaled down.
+        bool mipmap = false;
+        // the number of reduced levels, 0 for the full chain
+        int mipmapLevels = 0;
+        // the colors are multiplied by alpha, and drawn with the matching blending
+        bool premultipliedAlpha = false;
         Density density = Density::x1_0;
         
         static shared_ptr<Texture2D> createWithAsset(string filename);
+        // loads the asset from the directory of the density, without looking up the other densities.
+        static shared_ptr<Texture2D> createWithAsset(string filename, Density density);
+        // decodes the asset on a worker thread. the callback is invoked on the render thread once the texture is uploaded,
+        // with nullptr when the asset could not be loaded.
+        static void createWithAssetAsync(string filename, function<void(const shared_ptr<Texture2D> &texture)> callback);
         static shared_ptr<Texture2D> createWithFile(string filepath, Density density = Density::x1_0);
         static shared_ptr<Texture2D> createWithImage(unsigned char *image, int length);
         static shared_ptr<Texture2D> createWithText(string text, float fontSize, string fontFilename = "", float height = 0);
         static shared_ptr<Texture2D> createWithColor(TextureType textureType, const Color &color, int width, int height, Density density = Density::x1_0);
         static shared_ptr<Texture2D> createWithRGBA(unsigned char *data, int width, int height, Density density = Density::x1_0);
         
+        // the type of textures loaded from assets and files. a type set for the filename comes first, then the rule.
+        // the rule may be called from the loader threads.
+        static void setTextureType(string filename, TextureType textureType);
+        static void setTextureTypeRule(function<TextureType(Texture2D *texture)> rule);
+        static int getBytesPerPixel(TextureType textureType);
+        // called once per frame on the render thread, after the frame is drawn.
+        // textures uploaded and then packed into an atlas in the same frame keep their pixels for the atlas.
+        static void releaseUploadedData();
+        static void readPixel(TextureType textureType, const unsigned char *src, unsigned char *rgba);
+        // x and y select the threshold of the ordered dithering
+        static void writePixel(TextureType textureType, const unsigned char *rgba, unsigned char *dst, int x, int y, bool dither);
+        
         Texture2D();
         ~Texture2D();
         
         void bindTexture();
         void bindTextureSub(GLubyte* data, int x, int y, int width, int height);
+        // uploads the reduced levels again from level 0
+        void uploadMipmap();
+        // the reduced levels in the type of the texture. levels is 0 for the full chain.
+        vector<vector<unsigned char>> createMipmapLevels(int levels);
         void loadImageFromBuffer(unsigned char *buffer, int len);
+        void convert(TextureType textureType, bool dither = true);
+        bool isOpaque();
+        // decodes the pixels again if they have been released. returns false when there are no pixels.
+        bool loadData();
+        // frees the pixels unless they are retained, held by an atlas or cannot be decoded again.
+        void releaseData();
         
     private:
+        enum class Source {
+            Memory,
+            Asset,
+            File,
+        };
+        
+        static unordered_map<string, TextureType> textureTypes;
+        static function<TextureType(Texture2D *texture)> textureTypeRule;
+        static mutex textureTypeMutex;
+        static vector<weak_ptr<Texture2D>> uploadedTextures;
+        
+        // bytes of the last upload, and what they would have been in RGBA
+        long uploadedBytes = 0;
+        long uploadedRGBABytes = 0;
+        // where the pixels can be decoded again from
+        Source source = Source::Memory;
+        // the asset the texture was loaded from, decoded again from the same density
+        string assetPath;
+        // the data points into the mapping of a container instead of an own buffer
+        shared_ptr<MappedFile> mappedFile;
+        // levels stored back to back in the data, when they come from a container
+        int dataLevels = 1;
+        // atlases that compose the texture again on a repack, the pixels are kept while it is held
+        int atlasHoldCount = 0;
+        
+        void applyTextureType();
+        void freeData();
         void loadTextureAsset(string filename);
-        bool readBytesAsset(string filename, unsigned char **data, int *len, Density *density);
+        bool loadAssetPath(string path, Density density);
+        bool loadContainerAsset(string path);
+        bool loadContainer(const shared_ptr<MappedFile> &mappedFile, unsigned char *buffer, int len);
+        bool findAssetPath(string filename, string *path, Density *density);
         void loadTextureFile(string filepath, Density density = Density::x1_0);
         void loadFontTexture(string text, float fontSize, string fontFilename = "", float height = 0);
         void loadColorTexture(TextureType textureType, const Color &color, int width, int height, Density density = Density::x1_0);
@@ -1,8 +1,18 @@
 #include "mog/Constants.h"
 #include "mog/core/TextureAtlas.h"
 #include <stdlib.h>
+#include <limits.h>
+#include <string.h>
 #include <algorithm>
 
+#define ATLAS_INITIAL_SIZE 256
+// dirty areas closer than this many rows are uploaded together
+#define ATLAS_UPLOAD_GAP 16
+// a texel of level n covers 2^n pixels, and filtering reaches one more texel.
+// the levels up to 2 stay within a margin of 8 pixels.
+#define ATLAS_MIPMAP_MARGIN 8
+#define ATLAS_MIPMAP_LEVELS 2
+
 using namespace mog;
 
 #pragma - TextureAtlasCell
@@ -13,126 +23,597 @@ TextureAtlasCell::TextureAtlasCell(const shared_ptr<Texture2D> &texture) {
     this->height = texture->height;
 }
 
+int TextureAtlasCell::getSourceWidth() {
+    return this->rotated ? this->height : this->width;
+}
+
+int TextureAtlasCell::getSourceHeight() {
+    return this->rotated ? this->width : this->height;
+}
+
+bool TextureAtlasCell::isTrimmed() {
+    return (this->offsetX > 0 || this->offsetY > 0 ||
+            this->getSourceWidth() != this->texture->width || this->getSourceHeight() != this->texture->height);
+}
+
 
 #pragma - TextureAtlas
 
-void TextureAtlas::addTexture(const shared_ptr<Texture2D> &tex2d) {
-    if (this->cellMap.count(tex2d) > 0) return;
+TextureAtlas::~TextureAtlas() {
+    for (const auto &cell : this->cells) {
+        this->releaseCellData(cell);
+    }
+}
+
+void TextureAtlas::addTexture(const shared_ptr<Texture2D> &tex2d, bool trimmable) {
+    auto it = this->cellMap.find(tex2d);
+    if (it != this->cellMap.end()) {
+        auto &cell = it->second;
+        cell->used = true;
+        // a texture shared with an entity that is not a quad has to be packed in full
+        if (!trimmable && cell->trimmable) {
+            cell->trimmable = false;
+            if (cell->isTrimmed()) {
+                this->freeCell(cell);
+                this->trimCell(cell);
+            }
+        }
+        return;
+    }
     auto cell = make_shared<TextureAtlasCell>(tex2d);
+    cell->trimmable = trimmable;
+    if (tex2d->isAtlasPage) {
+        this->addBakedPage(cell);
+    } else {
+        this->holdCellData(cell);
+        this->trimCell(cell);
+    }
     this->cells.emplace_back(cell);
     this->cellMap[tex2d] = cell;
 }
 
+int TextureAtlas::getMargin() {
+    return this->enableMipmap ? ATLAS_MIPMAP_MARGIN : TEXTURE_MARGIN;
+}
+
+// a page baked offline is drawn as it is. it is kept in front of the packed pages, and is never packed or composed.
+void TextureAtlas::addBakedPage(const shared_ptr<TextureAtlasCell> &cell) {
+    int pageIndex = 0;
+    for (; pageIndex < this->pages.size() && this->pages[pageIndex].baked; pageIndex++) {
+        if (this->pages[pageIndex].texture == cell->texture) break;
+    }
+    if (pageIndex == this->pages.size() || !this->pages[pageIndex].baked) {
+        for (const auto &c : this->cells) {
+            if (c->page >= pageIndex) {
+                c->page++;
+            }
+        }
+        Page page;
+        page.width = cell->texture->width;
+        page.height = cell->texture->height;
+        page.texture = cell->texture;
+        page.baked = true;
+        page.dirtyTexture = (cell->texture->textureId == 0);
+        this->pages.insert(this->pages.begin() + pageIndex, page);
+    }
+    cell->page = pageIndex;
+    cell->placed = true;
+    cell->dirty = false;
+}
+
+int TextureAtlas::getBakedPageCount() {
+    int count = 0;
+    while (count < this->pages.size() && this->pages[count].baked) {
+        count++;
+    }
+    return count;
+}
+
+// finds the opaque area of the texture. the cell is left unrotated.
+void TextureAtlas::trimCell(const shared_ptr<TextureAtlasCell> &cell) {
+    auto tex2d = cell->texture;
+    cell->rotated = false;
+    cell->offsetX = 0;
+    cell->offsetY = 0;
+    cell->width = tex2d->width;
+    cell->height = tex2d->height;
+    if (!this->enableTrimming || !cell->trimmable) return;
+    if (tex2d->textureType == TextureType::RGB || tex2d->textureType == TextureType::RGB565) return;
+    if (!tex2d->loadData()) return;
+    
+    int bytesPerPixel = Texture2D::getBytesPerPixel(tex2d->textureType);
+    int minX = tex2d->width;
+    int minY = tex2d->height;
+    int maxX = -1;
+    int maxY = -1;
+    unsigned char rgba[4];
+    for (int y = 0; y < tex2d->height; y++) {
+        const unsigned char *row = &tex2d->data[y * tex2d->width * bytesPerPixel];
+        for (int x = 0; x < tex2d->width; x++) {
+            Texture2D::readPixel(tex2d->textureType, &row[x * bytesPerPixel], rgba);
+            if (rgba[3] == 0) continue;
+            minX = min(minX, x);
+            maxX = max(maxX, x);
+            minY = min(minY, y);
+            maxY = max(maxY, y);
+        }
+    }
+    // a fully transparent texture keeps a single pixel
+    if (maxX < 0) {
+        minX = 0;
+        minY = 0;
+        maxX = 0;
+        maxY = 0;
+    }
+    cell->offsetX = minX;
+    cell->offsetY = minY;
+    cell->width = maxX - minX + 1;
+    cell->height = maxY - minY + 1;
+}
+
+// places the cells added since the last call into free space.
+// all pages are packed again, and grown or added if needed, only when one of them does not fit.
 void TextureAtlas::mapTextureCells() {
-    vector<shared_ptr<TextureAtlasCell>> tmpCells = this->cells;
-    sort(tmpCells.begin(), tmpCells.end(), [](shared_ptr<TextureAtlasCell> cell1, shared_ptr<TextureAtlasCell> cell2) {
-        return cell1->texture->height > cell2->texture->height;
-    });
+    if (!this->pages.empty()) {
+        bool fits = true;
+        bool evicted = false;
+        for (int i = 0; i < this->cells.size(); i++) {
+            const auto &cell = this->cells[i];
+            if (cell->placed || this->placeCell(cell)) continue;
+            if (evicted) {
+                fits = false;
+                break;
+            }
+            this->evictUnusedCells();
+            evicted = true;
+            i = -1;
+        }
+        if (fits) return;
+    }
     
-    int x = 0;
-    int y = 0;
-    int mh = 0;
-    int mw = 0;
+    this->evictUnusedCells();
+    int width = ATLAS_INITIAL_SIZE;
+    int height = ATLAS_INITIAL_SIZE;
+    int bakedPageCount = this->getBakedPageCount();
+    if (this->pages.size() > bakedPageCount) {
+        width = max(width, this->pages[bakedPageCount].width);
+        height = max(height, this->pages[bakedPageCount].height);
+    }
+    // a single page is grown first, more pages are only used at the maximum size
+    while (!this->repack(width, height)) {
+        if (width >= MAX_TEXTURE_SIZE && height >= MAX_TEXTURE_SIZE) break;
+        if (width <= height) {
+            width = min(width * 2, MAX_TEXTURE_SIZE);
+        } else {
+            height = min(height * 2, MAX_TEXTURE_SIZE);
+        }
+    }
+}
 
-    for (const auto &cell : tmpCells) {
-        auto tex2d = cell->texture;
-        if (x > 0) x += TEXTURE_MARGIN * 2;
-        if (x + tex2d->width > MAX_TEXTURE_SIZE) {
-            y += mh + TEXTURE_MARGIN * 2;
-            if (y > MAX_TEXTURE_SIZE) break;
-            x = 0;
-            mh = 0;
+// packs all cells again into pages of the given size. returns false when more than one page is needed,
+// or when a texture is larger than a page.
+bool TextureAtlas::repack(int width, int height) {
+    // textures of the same size are reused, their pixels are composed again
+    int bakedPageCount = this->getBakedPageCount();
+    vector<shared_ptr<Texture2D>> textures;
+    for (int i = bakedPageCount; i < this->pages.size(); i++) {
+        const auto &page = this->pages[i];
+        if (page.texture && page.texture->width == width && page.texture->height == height) {
+            textures.emplace_back(page.texture);
         }
+    }
+    this->pages.erase(this->pages.begin() + bakedPageCount, this->pages.end());
+    
+    stable_sort(this->cells.begin(), this->cells.end(), [](const shared_ptr<TextureAtlasCell> &cell1, const shared_ptr<TextureAtlasCell> &cell2) {
+        return max(cell1->width, cell1->height) > max(cell2->width, cell2->height);
+    });
+    for (const auto &cell : this->cells) {
+        if (cell->texture->isAtlasPage) continue;
+        int sourceWidth = cell->getSourceWidth();
+        int sourceHeight = cell->getSourceHeight();
+        cell->placed = false;
+        cell->rotated = false;
+        cell->width = sourceWidth;
+        cell->height = sourceHeight;
+    }
+    bool placedAll = true;
+    for (const auto &cell : this->cells) {
+        if (cell->placed || this->placeCell(cell)) continue;
         
-        cell->x = x;
-        cell->y = y;
+        Page page;
+        page.width = width;
+        page.height = height;
+        Area area;
+        area.width = width;
+        area.height = height;
+        page.freeAreas.emplace_back(area);
+        if (this->pages.size() - bakedPageCount < textures.size()) {
+            page.texture = textures[this->pages.size() - bakedPageCount];
+        }
+        this->pages.emplace_back(page);
+        if (!this->placeCell(cell, (int)this->pages.size() - 1)) {
+            this->pages.pop_back();
+            placedAll = false;
+            if (width >= MAX_TEXTURE_SIZE && height >= MAX_TEXTURE_SIZE) {
+                LOGE("TextureAtlas::repack: a texture of %dx%d does not fit in %dx%d", cell->texture->width, cell->texture->height, width, height);
+            }
+        }
+    }
+    return placedAll && this->pages.size() - bakedPageCount <= 1;
+}
+
+bool TextureAtlas::placeCell(const shared_ptr<TextureAtlasCell> &cell) {
+    for (int i = 0; i < this->pages.size(); i++) {
+        if (this->placeCell(cell, i)) return true;
+    }
+    return false;
+}
+
+// every cell is surrounded by a margin, so the edges can be extended without touching the neighbours.
+// the free area that leaves the shortest side is chosen.
+bool TextureAtlas::placeCell(const shared_ptr<TextureAtlasCell> &cell, int pageIndex) {
+    auto &page = this->pages[pageIndex];
+    int margin = this->getMargin();
+    int w = cell->getSourceWidth() + margin * 2;
+    int h = cell->getSourceHeight() + margin * 2;
+    
+    int bestIndex = -1;
+    int bestShortSide = INT_MAX;
+    int bestLongSide = INT_MAX;
+    bool bestRotated = false;
+    for (int i = 0; i < page.freeAreas.size(); i++) {
+        const auto &free = page.freeAreas[i];
+        for (int r = 0; r < (this->enableRotation ? 2 : 1); r++) {
+            int aw = (r == 0) ? w : h;
+            int ah = (r == 0) ? h : w;
+            if (aw > free.width || ah > free.height) continue;
+            int shortSide = min(free.width - aw, free.height - ah);
+            int longSide = max(free.width - aw, free.height - ah);
+            if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+                bestIndex = i;
+                bestShortSide = shortSide;
+                bestLongSide = longSide;
+                bestRotated = (r == 1);
+            }
+        }
+    }
+    if (bestIndex < 0) return false;
+    
+    Area area;
+    area.x = page.freeAreas[bestIndex].x;
+    area.y = page.freeAreas[bestIndex].y;
+    area.width = bestRotated ? h : w;
+    area.height = bestRotated ? w : h;
+    this->splitFreeAreas(page, area);
+    
+    int sourceWidth = cell->getSourceWidth();
+    int sourceHeight = cell->getSourceHeight();
+    cell->rotated = bestRotated;
+    cell->width = bestRotated ? sourceHeight : sourceWidth;
+    cell->height = bestRotated ? sourceWidth : sourceHeight;
+    cell->page = pageIndex;
+    cell->x = area.x + margin;
+    cell->y = area.y + margin;
+    cell->placed = true;
+    cell->dirty = true;
+    return true;
+}
+
+// removes the used area from the free areas, keeping the rest as maximal rectangles.
+void TextureAtlas::splitFreeAreas(Page &page, const Area &area) {
+    vector<Area> areas;
+    for (const auto &free : page.freeAreas) {
+        if (area.x >= free.x + free.width || area.x + area.width <= free.x ||
+            area.y >= free.y + free.height || area.y + area.height <= free.y) {
+            areas.emplace_back(free);
+            continue;
+        }
         
-        x += tex2d->width;
-        mh = max(mh, tex2d->height);
-        mw = max(mw, x);
+        if (area.x > free.x) {
+            Area a = free;
+            a.width = area.x - free.x;
+            areas.emplace_back(a);
+        }
+        if (area.x + area.width < free.x + free.width) {
+            Area a = free;
+            a.x = area.x + area.width;
+            a.width = free.x + free.width - a.x;
+            areas.emplace_back(a);
+        }
+        if (area.y > free.y) {
+            Area a = free;
+            a.height = area.y - free.y;
+            areas.emplace_back(a);
+        }
+        if (area.y + area.height < free.y + free.height) {
+            Area a = free;
+            a.y = area.y + area.height;
+            a.height = free.y + free.height - a.y;
+            areas.emplace_back(a);
+        }
+    }
+    
+    // drop the areas contained in another one
+    for (int i = 0; i < areas.size(); i++) {
+        for (int j = 0; j < areas.size(); j++) {
+            if (i == j) continue;
+            if (areas[i].x >= areas[j].x && areas[i].y >= areas[j].y &&
+                areas[i].x + areas[i].width <= areas[j].x + areas[j].width &&
+                areas[i].y + areas[i].height <= areas[j].y + areas[j].height) {
+                areas.erase(areas.begin() + i);
+                i--;
+                break;
+            }
+        }
     }
+    page.freeAreas.swap(areas);
+}
+
+// returns the area of the cell to its page. the pixels stay until another cell is placed there.
+void TextureAtlas::freeCell(const shared_ptr<TextureAtlasCell> &cell) {
+    if (!cell->placed || cell->texture->isAtlasPage) return;
+    cell->placed = false;
+    if (cell->page >= this->pages.size()) return;
     
-    this->width = mw;
-    this->height = y + mh;
+    int margin = this->getMargin();
+    Area area;
+    area.x = cell->x - margin;
+    area.y = cell->y - margin;
+    area.width = cell->width + margin * 2;
+    area.height = cell->height + margin * 2;
+    this->pages[cell->page].freeAreas.emplace_back(area);
+}
+
+// the pixels of a held texture survive its upload, so a repack composes it without decoding.
+void TextureAtlas::holdCellData(const shared_ptr<TextureAtlasCell> &cell) {
+    if (cell->holdingData) return;
+    cell->holdingData = true;
+    cell->texture->atlasHoldCount++;
+}
+
+void TextureAtlas::releaseCellData(const shared_ptr<TextureAtlasCell> &cell) {
+    if (!cell->holdingData) return;
+    cell->holdingData = false;
+    cell->texture->atlasHoldCount--;
+    cell->texture->releaseData();
+}
+
+// releases the cells that were not used by the last build.
+void TextureAtlas::evictUnusedCells() {
+    for (const auto &cell : this->cells) {
+        if (cell->used) continue;
+        this->cellMap.erase(cell->texture);
+        this->freeCell(cell);
+        this->releaseCellData(cell);
+    }
+    this->cells.erase(remove_if(this->cells.begin(), this->cells.end(), [](const shared_ptr<TextureAtlasCell> &cell) {
+        return !cell->used;
+    }), this->cells.end());
 }
 
+// packs the cells and returns the texture of the first page.
+// a page texture is only recreated when the page has been resized.
 shared_ptr<Texture2D> TextureAtlas::createTexture() {
     this->mapTextureCells();
+    for (const auto &cell : this->cells) {
+        cell->used = false;
+    }
     
-    int bitsPerPixel = 4;
-    auto textureType = TextureType::RGBA;
-    
-    this->texture = make_shared<Texture2D>();
-    this->texture->textureType = textureType;
-    this->texture->width = this->width;
-    this->texture->height = this->height;
-    this->texture->bitsPerPixel = bitsPerPixel;
-    this->texture->dataLength = this->texture->width * this->texture->height * bitsPerPixel;
+    for (auto &page : this->pages) {
+        if (page.texture && page.texture->width == page.width && page.texture->height == page.height) continue;
+        
+        int bitsPerPixel = Texture2D::getBytesPerPixel(this->textureType);
+        auto textureType = this->textureType;
+        
+        page.texture = make_shared<Texture2D>();
+        page.texture->textureType = textureType;
+        page.texture->width = page.width;
+        page.texture->height = page.height;
+        page.texture->bitsPerPixel = bitsPerPixel;
+        page.texture->dataLength = page.texture->width * page.texture->height * bitsPerPixel;
+        page.texture->data = (GLubyte *)calloc(page.texture->dataLength, sizeof(GLubyte));
+        page.texture->mipmap = this->enableMipmap;
+        page.texture->mipmapLevels = ATLAS_MIPMAP_LEVELS;
+        page.dirtyTexture = true;
+    }
     
-    return this->texture;
+    return this->getTexture(0);
 }
 
-void TextureAtlas::bindTexture() {
-    this->texture->bindTexture();
-    
+int TextureAtlas::getPageCount() {
+    return (int)this->pages.size();
+}
+
+shared_ptr<Texture2D> TextureAtlas::getTexture(int page) {
+    if (page < 0 || page >= this->pages.size()) return nullptr;
+    return this->pages[page].texture;
+}
+
+// maps a texture coord of the whole source texture to the page of the cell.
+void TextureAtlas::mapTexCoord(const shared_ptr<TextureAtlasCell> &cell, float s, float t, float *u, float *v) {
+    const auto &page = this->pages[cell->page];
+    float x = s * cell->texture->width - cell->offsetX;
+    float y = t * cell->texture->height - cell->offsetY;
+    if (cell->rotated) {
+        // rotated clockwise, the left edge of the source is the top edge in the page
+        *u = (cell->x + cell->getSourceHeight() - y) / page.width;
+        *v = (cell->y + x) / page.height;
+    } else {
+        *u = (cell->x + x) / page.width;
+        *v = (cell->y + y) / page.height;
+    }
+}
+
+long TextureAtlas::getUsedArea() {
+    long area = 0;
     for (const auto &cell : this->cells) {
-        this->bindTextureSub(cell);
+        if (cell->placed) {
+            area += (long)cell->width * cell->height;
+        }
+    }
+    return area;
+}
+
+long TextureAtlas::getPageArea() {
+    long area = 0;
+    for (const auto &page : this->pages) {
+        area += (long)page.width * page.height;
     }
+    return area;
 }
 
-void TextureAtlas::bindTextureSub(const shared_ptr<TextureAtlasCell> &cell) {
-    this->texture->bindTextureSub(cell->texture->data, cell->x, cell->y, cell->width, cell->height);
+// composes the cells placed since the last call into the pixels of their page, and uploads only the changed rows.
+// a page that has been packed again is composed from scratch and uploaded at once.
+void TextureAtlas::bindTexture() {
+    this->composeTexture();
     
-    if (cell->x > 0) {
-        int marginL = TEXTURE_MARGIN;
-        unsigned char *dt = new unsigned char[cell->height * 4];
-        this->readTexturePixels(dt, cell->texture, 0, 0, 1, cell->height);
-        for (int i = 1; i <= marginL; i++) {
-            this->texture->bindTextureSub(dt, cell->x - i, cell->y, 1, cell->height);
+    for (auto &page : this->pages) {
+        if (page.dirtyTexture) {
+            page.texture->bindTexture();
+            page.dirtyAreas.clear();
+            page.dirtyTexture = false;
+        } else {
+            this->uploadDirtyAreas(page);
         }
-        safe_delete_arr(dt);
+    }
+}
+
+// composes the cells into the pixels of the pages without uploading them.
+// the pixels of the textures are kept for the next repack, unless the data release is enabled.
+void TextureAtlas::composeTexture() {
+    for (auto &page : this->pages) {
+        if (!page.dirtyTexture || page.baked) continue;
+        memset(page.texture->data, 0, page.texture->dataLength);
     }
     
-    int marginR = min(this->width - (cell->x + cell->width), TEXTURE_MARGIN);
-    if (marginR > 0) {
-        unsigned char *dt = new unsigned char[cell->height * 4];
-        this->readTexturePixels(dt, cell->texture, cell->width - 1, 0, 1, cell->height);
-        for (int i = 0; i < marginR; i++) {
-            this->texture->bindTextureSub(dt, cell->x + cell->width + i, cell->y, 1, cell->height);
+    for (const auto &cell : this->cells) {
+        if (!cell->placed) continue;
+        auto &page = this->pages[cell->page];
+        if (!cell->dirty && !page.dirtyTexture) continue;
+        this->composeCell(page, cell);
+        if (this->enableDataRelease) {
+            this->releaseCellData(cell);
         }
-        safe_delete_arr(dt);
+        cell->dirty = false;
     }
+}
+
+// copies the cell into the pixels of the page, and extends its edges into the margin.
+void TextureAtlas::composeCell(Page &page, const shared_ptr<TextureAtlasCell> &cell) {
+    if (!cell->texture->loadData()) return;
+    unsigned char *data = page.texture->data;
+    int bytesPerPixel = Texture2D::getBytesPerPixel(page.texture->textureType);
+    int stride = page.width * bytesPerPixel;
+    int margin = this->getMargin();
+    this->readTexturePixels(&data[cell->y * stride + cell->x * bytesPerPixel], stride, cell, page.texture->textureType);
     
-    if (cell->y > 0) {
-        int marginT = TEXTURE_MARGIN;
-        unsigned char *dt = new unsigned char[cell->width * 4];
-        this->readTexturePixels(dt, cell->texture, 0, 0, cell->width, 1);
-        for (int i = 1; i <= marginT; i++) {
-            this->texture->bindTextureSub(dt, cell->x, cell->y - i, cell->width, 1);
+    int marginL = min(cell->x, margin);
+    int marginR = min(page.width - (cell->x + cell->width), margin);
+    int marginT = min(cell->y, margin);
+    int marginB = min(page.height - (cell->y + cell->height), margin);
+    for (int y = cell->y; y < cell->y + cell->height; y++) {
+        unsigned char *row = &data[y * stride];
+        for (int i = 1; i <= marginL; i++) {
+            memcpy(&row[(cell->x - i) * bytesPerPixel], &row[cell->x * bytesPerPixel], bytesPerPixel);
         }
-        safe_delete_arr(dt);
+        for (int i = 0; i < marginR; i++) {
+            memcpy(&row[(cell->x + cell->width + i) * bytesPerPixel], &row[(cell->x + cell->width - 1) * bytesPerPixel], bytesPerPixel);
+        }
+    }
+    // the rows of the margin include the corners
+    int x = cell->x - marginL;
+    int rowLength = (marginL + cell->width + marginR) * bytesPerPixel;
+    for (int i = 1; i <= marginT; i++) {
+        memcpy(&data[(cell->y - i) * stride + x * bytesPerPixel], &data[cell->y * stride + x * bytesPerPixel], rowLength);
+    }
+    for (int i = 0; i < marginB; i++) {
+        memcpy(&data[(cell->y + cell->height + i) * stride + x * bytesPerPixel], &data[(cell->y + cell->height - 1) * stride + x * bytesPerPixel], rowLength);
     }
     
-    int marginB = min(this->height - (cell->y + cell->height), TEXTURE_MARGIN);
-    if (marginB > 0) {
-        unsigned char *dt = new unsigned char[cell->width * 4];
-        this->readTexturePixels(dt, cell->texture, 0, cell->height - 1, cell->width, 1);
-        for (int i = 0; i < marginB; i++) {
-            this->texture->bindTextureSub(dt, cell->x, cell->y + cell->height + i, cell->width, 1);
+    Area area;
+    area.x = x;
+    area.y = cell->y - marginT;
+    area.width = marginL + cell->width + marginR;
+    area.height = marginT + cell->height + marginB;
+    page.dirtyAreas.emplace_back(area);
+}
+
+// full rows are contiguous in the pixels of the page, so nearby areas are merged into bands of rows
+// and uploaded without copying.
+void TextureAtlas::uploadDirtyAreas(Page &page) {
+    if (page.dirtyAreas.empty()) return;
+    
+    sort(page.dirtyAreas.begin(), page.dirtyAreas.end(), [](const Area &area1, const Area &area2) {
+        return area1.y < area2.y;
+    });
+    int stride = page.width * Texture2D::getBytesPerPixel(page.texture->textureType);
+    int top = page.dirtyAreas[0].y;
+    int bottom = top + page.dirtyAreas[0].height;
+    for (int i = 1; i <= page.dirtyAreas.size(); i++) {
+        if (i < page.dirtyAreas.size()) {
+            const auto &area = page.dirtyAreas[i];
+            if (area.y <= bottom + ATLAS_UPLOAD_GAP) {
+                bottom = max(bottom, area.y + area.height);
+                continue;
+            }
         }
-        safe_delete_arr(dt);
+        page.texture->bindTextureSub(&page.texture->data[top * stride], 0, top, page.width, bottom - top);
+        if (i < page.dirtyAreas.size()) {
+            top = page.dirtyAreas[i].y;
+            bottom = top + page.dirtyAreas[i].height;
+        }
+    }
+    page.dirtyAreas.clear();
+    if (page.texture->mipmap) {
+        page.texture->uploadMipmap();
     }
 }
 
-void TextureAtlas::readTexturePixels(unsigned char *dst, const shared_ptr<Texture2D> &tex2d, int x, int y, int width, int height) {
-    for (int _y = 0; _y < height; _y++) {
-        int di = _y * width;
-        int si = (y + _y) * tex2d->width + x;
-        memcpy(&dst[di * 4], &tex2d->data[si * 4], sizeof(unsigned char) * width * 4);
+// reads the pixels of the cell in page orientation, from its trimmed and possibly rotated source.
+// pixels of another type than the page are converted with dithering.
+// the pages hold straight colors, premultiplied textures are divided by alpha.
+void TextureAtlas::readTexturePixels(unsigned char *dst, int stride, const shared_ptr<TextureAtlasCell> &cell, TextureType textureType) {
+    auto tex2d = cell->texture;
+    int srcBytesPerPixel = Texture2D::getBytesPerPixel(tex2d->textureType);
+    int bytesPerPixel = Texture2D::getBytesPerPixel(textureType);
+    bool copy = (tex2d->textureType == textureType && !tex2d->premultipliedAlpha);
+    if (!cell->rotated && copy) {
+        for (int y = 0; y < cell->height; y++) {
+            int si = (cell->offsetY + y) * tex2d->width + cell->offsetX;
+            memcpy(&dst[y * stride], &tex2d->data[si * bytesPerPixel], sizeof(unsigned char) * cell->width * bytesPerPixel);
+        }
+        return;
+    }
+    
+    int sourceHeight = cell->getSourceHeight();
+    unsigned char rgba[4];
+    for (int y = 0; y < cell->height; y++) {
+        unsigned char *d = &dst[y * stride];
+        for (int x = 0; x < cell->width; x++, d += bytesPerPixel) {
+            int sx = x;
+            int sy = y;
+            if (cell->rotated) {
+                sx = y;
+                sy = sourceHeight - 1 - x;
+            }
+            int si = (cell->offsetY + sy) * tex2d->width + cell->offsetX + sx;
+            if (copy) {
+                memcpy(d, &tex2d->data[si * bytesPerPixel], bytesPerPixel);
+            } else {
+                Texture2D::readPixel(tex2d->textureType, &tex2d->data[si * srcBytesPerPixel], rgba);
+                if (tex2d->premultipliedAlpha && rgba[3] > 0) {
+                    for (int c = 0; c < 3; c++) {
+                        rgba[c] = (unsigned char)min(255, (rgba[c] * 255 + rgba[3] / 2) / rgba[3]);
+                    }
+                }
+                Texture2D::writePixel(textureType, rgba, d, x, y, true);
+            }
+        }
     }
 }
 
 shared_ptr<TextureAtlasCell> TextureAtlas::getCell(const shared_ptr<Texture2D> &tex2d) {
-    return this->cellMap[tex2d];
+    auto it = this->cellMap.find(tex2d);
+    if (it == this->cellMap.end()) return nullptr;
+    return it->second;
 }
-
@@ -12,42 +12,97 @@ namespace mog {
     class TextureAtlasCell {
     public:
         shared_ptr<Texture2D> texture;
+        int page = 0;
+        // the area in the page, without the margin. width and height are swapped when the cell is rotated.
         int x = 0;
         int y = 0;
         int width = 0;
         int height = 0;
+        // the opaque area of the texture when its transparent borders are trimmed
+        int offsetX = 0;
+        int offsetY = 0;
+        bool rotated = false;
+        // only textures drawn as quads can be trimmed, the quads are clipped to the opaque area
+        bool trimmable = true;
+        bool placed = false;
+        // referenced by the last build. unused cells keep their pixels until the space is needed.
+        bool used = true;
+        bool dirty = true;
+        // the texture keeps its pixels for the next repack
+        bool holdingData = false;
         
         TextureAtlasCell(const shared_ptr<Texture2D> &texture);
+        int getSourceWidth();
+        int getSourceHeight();
+        bool isTrimmed();
     };
     
     
+    // a persistent atlas. textures are packed with MaxRects and stay in place across rebuilds,
+    // so only newly added textures are uploaded. pages are repacked only when a texture no longer fits,
+    // and textures that do not fit into one page of MAX_TEXTURE_SIZE spill to more pages.
     class TextureAtlas {
     public:
-        int width = 0;
-        int height = 0;
-        shared_ptr<Texture2D> texture;
+        bool enableRotation = false;
+        bool enableTrimming = false;
+        // the pages are mipmapped, and the cells get a wider margin so the reduced levels do not bleed.
+        bool enableMipmap = false;
+        // the pixels of the textures are released once they are composed, instead of kept while the atlas holds them.
+        // it saves their memory for atlases that are not expected to repack, since a repack, a grown page or
+        // a page composed again then decodes every texture again on the render thread.
+        bool enableDataRelease = false;
+        // the type of the pages. textures of other types are converted while they are composed.
+        TextureType textureType = TextureType::RGBA;
         
-        void addTexture(const shared_ptr<Texture2D> &tex2d);
+        void addTexture(const shared_ptr<Texture2D> &tex2d, bool trimmable = false);
 //        shared_ptr<TextureAtlasCell> addTexture(const shared_ptr<Texture2D> &tex2d);
 //        void apply();
         
 //        static vector<shared_ptr<TextureAtlas>> createTextureAtlas(const vector<shared_ptr<Texture2D>> &textures);
         
         TextureAtlas() {};
+        ~TextureAtlas();
 //        TextureAtlas(const vector<shared_ptr<Texture2D>> &textures);
 //        TextureAtlas(const vector<shared_ptr<TextureAtlasCell>> &cells, int width, int height);
         shared_ptr<Texture2D> createTexture();
         shared_ptr<TextureAtlasCell> getCell(const shared_ptr<Texture2D> &tex2d);
+        int getPageCount();
+        shared_ptr<Texture2D> getTexture(int page = 0);
+        void mapTexCoord(const shared_ptr<TextureAtlasCell> &cell, float s, float t, float *u, float *v);
+        long getUsedArea();
+        long getPageArea();
         
         void bindTexture();
-        void bindTextureSub(const shared_ptr<TextureAtlasCell> &cell);
+        void composeTexture();
 //        void bindTextureSub(shared_ptr<Texture2D> tex2d);
 
         
     private:
+        struct Area {
+            int x = 0;
+            int y = 0;
+            int width = 0;
+            int height = 0;
+        };
+        
+        // the pixels of a page are composed in the data of its texture, and uploaded from there.
+        struct Page {
+            int width = 0;
+            int height = 0;
+            shared_ptr<Texture2D> texture;
+            // maximal free rectangles, they may overlap each other
+            vector<Area> freeAreas;
+            // areas composed since the last upload, with their margins
+            vector<Area> dirtyAreas;
+            bool dirtyTexture = true;
+            // a page baked offline, drawn from its own texture
+            bool baked = false;
+        };
+        
 //        vector<shared_ptr<Texture2D>> textures;
         vector<shared_ptr<TextureAtlasCell>> cells;
         unordered_map<shared_ptr<Texture2D>, shared_ptr<TextureAtlasCell>> cellMap;
+        vector<Page> pages;
         
         /*
         int _x = 0;
@@ -57,8 +112,22 @@ namespace mog {
         bool applyed = false;
          */
         
+        int getMargin();
+        void addBakedPage(const shared_ptr<TextureAtlasCell> &cell);
+        int getBakedPageCount();
         void mapTextureCells();
-        void readTexturePixels(unsigned char *dst, const shared_ptr<Texture2D> &tex2d, int x, int y, int width, int height);
+        bool placeCell(const shared_ptr<TextureAtlasCell> &cell);
+        bool placeCell(const shared_ptr<TextureAtlasCell> &cell, int page);
+        void splitFreeAreas(Page &page, const Area &area);
+        void freeCell(const shared_ptr<TextureAtlasCell> &cell);
+        void holdCellData(const shared_ptr<TextureAtlasCell> &cell);
+        void releaseCellData(const shared_ptr<TextureAtlasCell> &cell);
+        void evictUnusedCells();
+        bool repack(int width, int height);
+        void trimCell(const shared_ptr<TextureAtlasCell> &cell);
+        void composeCell(Page &page, const shared_ptr<TextureAtlasCell> &cell);
+        void uploadDirtyAreas(Page &page);
+        void readTexturePixels(unsigned char *dst, int stride, const shared_ptr<TextureAtlasCell> &cell, TextureType textureType);
     };
 }
 
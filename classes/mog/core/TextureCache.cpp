@@ -0,0 +1,136 @@
+#include "mog/Constants.h"
+#include "mog/core/TextureCache.h"
+#include "mog/core/MogStats.h"
+
+#define TEXTURE_CACHE_BUDGET (32 * 1024 * 1024)
+
+using namespace mog;
+
+TextureCache *TextureCache::instance;
+
+TextureCache *TextureCache::getInstance() {
+    if (TextureCache::instance == nullptr) {
+        TextureCache::instance = new TextureCache();
+    }
+    return TextureCache::instance;
+}
+
+string TextureCache::getKey(string filename, Density density, string variant) {
+    return filename + "@" + to_string(density.idx) + "#" + variant;
+}
+
+// assets are looked up from the current density
+string TextureCache::getKey(string filename, string variant) {
+    return TextureCache::getKey(filename, Density::getCurrent(), variant);
+}
+
+TextureCache::TextureCache() {
+    this->budget = TEXTURE_CACHE_BUDGET;
+}
+
+shared_ptr<Texture2D> TextureCache::get(string key) {
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) {
+        MogStats::textureCacheMissCount++;
+        return nullptr;
+    }
+    MogStats::textureCacheHitCount++;
+    this->lru.splice(this->lru.begin(), this->lru, it->second.lruIterator);
+    return it->second.texture;
+}
+
+shared_ptr<Texture2D> TextureCache::getOrCreate(string key, function<shared_ptr<Texture2D>()> create) {
+    auto texture = this->get(key);
+    if (texture) return texture;
+
+    texture = create();
+    if (texture) {
+        this->put(key, texture);
+    }
+    return texture;
+}
+
+void TextureCache::put(string key, const shared_ptr<Texture2D> &texture) {
+    this->remove(key);
+
+    Entry entry;
+    entry.texture = texture;
+    entry.bytes = (long)texture->width * texture->height * Texture2D::getBytesPerPixel(texture->textureType);
+    this->lru.push_front(key);
+    entry.lruIterator = this->lru.begin();
+    this->entries[key] = entry;
+}
+
+// the texture stays alive while it is referenced, but is no longer shared.
+void TextureCache::remove(string key) {
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) return;
+    this->lru.erase(it->second.lruIterator);
+    this->entries.erase(it);
+}
+
+void TextureCache::pin(string key) {
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) return;
+    it->second.pinned = true;
+}
+
+void TextureCache::unpin(string key) {
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) return;
+    it->second.pinned = false;
+}
+
+// only the cache holds an unreferenced texture
+bool TextureCache::isEvictable(const Entry &entry) {
+    return !entry.pinned && entry.texture.use_count() == 1;
+}
+
+void TextureCache::trim(long bytes) {
+    long unreferencedBytes = this->getCachedBytes();
+    auto it = this->lru.end();
+    while (unreferencedBytes > bytes && it != this->lru.begin()) {
+        --it;
+        const auto &entry = this->entries[*it];
+        if (!TextureCache::isEvictable(entry)) continue;
+        unreferencedBytes -= entry.bytes;
+        string key = *it;
+        it = this->lru.erase(it);
+        this->evict(key);
+    }
+}
+
+void TextureCache::trimToBudget() {
+    this->trim(this->budget);
+}
+
+void TextureCache::clear() {
+    for (auto &pair : this->entries) {
+        pair.second.pinned = false;
+    }
+    this->trim(0);
+}
+
+void TextureCache::evict(const string &key) {
+    this->entries.erase(key);
+    MogStats::textureCacheEvictCount++;
+}
+
+void TextureCache::setBudget(long bytes) {
+    this->budget = bytes;
+    this->trim(this->budget);
+}
+
+long TextureCache::getBudget() {
+    return this->budget;
+}
+
+long TextureCache::getCachedBytes() {
+    long bytes = 0;
+    for (const auto &pair : this->entries) {
+        if (TextureCache::isEvictable(pair.second)) {
+            bytes += pair.second.bytes;
+        }
+    }
+    return bytes;
+}
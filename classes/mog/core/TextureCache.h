@@ -0,0 +1,63 @@
+#ifndef TextureCache_h
+#define TextureCache_h
+
+#include <memory>
+#include <string>
+#include <list>
+#include <functional>
+#include <unordered_map>
+#include "mog/core/Texture2D.h"
+#include "mog/core/Density.h"
+
+using namespace std;
+
+namespace mog {
+
+    // textures shared by filename, density and variant.
+    // a texture stays cached while it is referenced. unreferenced textures are kept within the byte budget
+    // and evicted in least recently used order. pinned textures are never evicted and, like referenced ones,
+    // do not count toward the budget. references change outside the cache, so the engine trims once per frame.
+    class TextureCache {
+    public:
+        static TextureCache *getInstance();
+        static string getKey(string filename, Density density, string variant = "");
+        static string getKey(string filename, string variant = "");
+
+        shared_ptr<Texture2D> get(string key);
+        shared_ptr<Texture2D> getOrCreate(string key, function<shared_ptr<Texture2D>()> create);
+        void put(string key, const shared_ptr<Texture2D> &texture);
+        void remove(string key);
+        void pin(string key);
+        void unpin(string key);
+        // evicts unreferenced textures until their bytes fit in the given bytes.
+        void trim(long bytes);
+        void trimToBudget();
+        void clear();
+
+        void setBudget(long bytes);
+        long getBudget();
+        // bytes of the unpinned textures only the cache holds
+        long getCachedBytes();
+
+    private:
+        struct Entry {
+            shared_ptr<Texture2D> texture;
+            long bytes = 0;
+            bool pinned = false;
+            list<string>::iterator lruIterator;
+        };
+
+        static TextureCache *instance;
+
+        unordered_map<string, Entry> entries;
+        // most recently used first
+        list<string> lru;
+        long budget;
+
+        TextureCache();
+        static bool isEvictable(const Entry &entry);
+        void evict(const string &key);
+    };
+}
+
+#endif /* TextureCache_h */
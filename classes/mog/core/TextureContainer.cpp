@@ -0,0 +1,128 @@
+#include "mog/Constants.h"
+#include "mog/core/TextureContainer.h"
+#include "mog/core/FileUtils.h"
+#include <string.h>
+#include <limits.h>
+#include <vector>
+
+#define TEXTURE_CONTAINER_MAGIC "MOGT"
+#define TEXTURE_CONTAINER_VERSION 1
+#define TEXTURE_CONTAINER_HEADER_SIZE 32
+#define TEXTURE_CONTAINER_FLAG_PREMULTIPLIED 0x01
+#define TEXTURE_TYPE_NUM 6
+
+using namespace mog;
+
+static unsigned int readUInt32(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static void writeUInt32(unsigned char *p, unsigned int value) {
+    p[0] = value & 0xff;
+    p[1] = (value >> 8) & 0xff;
+    p[2] = (value >> 16) & 0xff;
+    p[3] = (value >> 24) & 0xff;
+}
+
+static int getLevelLength(TextureType textureType, int width, int height, int level) {
+    int w = max(1, width >> level);
+    int h = max(1, height >> level);
+    return w * h * Texture2D::getBytesPerPixel(textureType);
+}
+
+bool TextureContainer::isContainer(string filename) {
+    string extension = TEXTURE_CONTAINER_EXTENSION;
+    return filename.length() > extension.length() &&
+        filename.compare(filename.length() - extension.length(), extension.length(), extension) == 0;
+}
+
+string TextureContainer::getContainerName(string filename) {
+    auto dot = filename.find_last_of('.');
+    auto slash = filename.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return filename + TEXTURE_CONTAINER_EXTENSION;
+    }
+    return filename.substr(0, dot) + TEXTURE_CONTAINER_EXTENSION;
+}
+
+bool TextureContainer::readHeader(const unsigned char *data, int len, Header *header) {
+    if (data == nullptr || len < TEXTURE_CONTAINER_HEADER_SIZE) return false;
+    if (memcmp(data, TEXTURE_CONTAINER_MAGIC, 4) != 0) return false;
+    int version = data[4] | (data[5] << 8);
+    if (version != TEXTURE_CONTAINER_VERSION || data[6] >= TEXTURE_TYPE_NUM) return false;
+
+    header->textureType = (TextureType)data[6];
+    header->premultipliedAlpha = (data[7] & TEXTURE_CONTAINER_FLAG_PREMULTIPLIED) != 0;
+    header->width = (int)readUInt32(&data[8]);
+    header->height = (int)readUInt32(&data[12]);
+    header->levels = (int)readUInt32(&data[16]);
+    header->dataOffset = (int)readUInt32(&data[20]);
+    header->dataLength = (int)readUInt32(&data[24]);
+    if (header->width <= 0 || header->height <= 0 || header->levels <= 0) return false;
+
+    // the chain ends at 1x1, and the lengths of the levels are ints
+    int maxLevels = 1;
+    for (int size = max(header->width, header->height); size > 1; size >>= 1) {
+        maxLevels++;
+    }
+    long long length = (long long)header->width * header->height * Texture2D::getBytesPerPixel(header->textureType);
+    if (header->levels > maxLevels || length > INT_MAX) {
+        LOGE("TextureContainer::readHeader: the size of the container is invalid.");
+        return false;
+    }
+
+    long long dataLength = 0;
+    for (int i = 0; i < header->levels; i++) {
+        dataLength += getLevelLength(header->textureType, header->width, header->height, i);
+    }
+    if (header->dataOffset < TEXTURE_CONTAINER_HEADER_SIZE || header->dataLength != dataLength ||
+        (long long)header->dataOffset + header->dataLength > len) {
+        LOGE("TextureContainer::readHeader: the container is truncated.");
+        return false;
+    }
+    return true;
+}
+
+int TextureContainer::getLevelOffset(const Header &header, int level) {
+    int offset = 0;
+    for (int i = 0; i < level; i++) {
+        offset += getLevelLength(header.textureType, header.width, header.height, i);
+    }
+    return offset;
+}
+
+bool TextureContainer::write(const shared_ptr<Texture2D> &texture, string filepath, bool mipmap) {
+    if (!texture->loadData()) return false;
+
+    vector<vector<unsigned char>> reducedLevels;
+    if (mipmap) {
+        reducedLevels = texture->createMipmapLevels(0);
+    }
+    int levels = 1 + (int)reducedLevels.size();
+    int dataLength = 0;
+    for (int i = 0; i < levels; i++) {
+        dataLength += getLevelLength(texture->textureType, texture->width, texture->height, i);
+    }
+
+    vector<unsigned char> buffer(TEXTURE_CONTAINER_HEADER_SIZE + dataLength, 0);
+    memcpy(&buffer[0], TEXTURE_CONTAINER_MAGIC, 4);
+    buffer[4] = TEXTURE_CONTAINER_VERSION & 0xff;
+    buffer[5] = (TEXTURE_CONTAINER_VERSION >> 8) & 0xff;
+    buffer[6] = (unsigned char)texture->textureType;
+    buffer[7] = texture->premultipliedAlpha ? TEXTURE_CONTAINER_FLAG_PREMULTIPLIED : 0;
+    writeUInt32(&buffer[8], texture->width);
+    writeUInt32(&buffer[12], texture->height);
+    writeUInt32(&buffer[16], levels);
+    writeUInt32(&buffer[20], TEXTURE_CONTAINER_HEADER_SIZE);
+    writeUInt32(&buffer[24], dataLength);
+
+    int offset = TEXTURE_CONTAINER_HEADER_SIZE;
+    int length = getLevelLength(texture->textureType, texture->width, texture->height, 0);
+    memcpy(&buffer[offset], texture->data, length);
+    offset += length;
+    for (const auto &level : reducedLevels) {
+        memcpy(&buffer[offset], level.data(), level.size());
+        offset += (int)level.size();
+    }
+    return FileUtils::writeDataToFile(filepath, buffer.data(), (int)buffer.size());
+}
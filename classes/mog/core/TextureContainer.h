@@ -0,0 +1,43 @@
+#ifndef TextureContainer_h
+#define TextureContainer_h
+
+#include <memory>
+#include <string>
+#include "mog/core/Texture2D.h"
+
+#define TEXTURE_CONTAINER_EXTENSION ".mogtex"
+
+using namespace std;
+
+namespace mog {
+
+    // the engine's own texture file. a header followed by the raw pixels of each level, so it is uploaded without decoding.
+    // the levels are stored from the largest, rows tightly packed, in the pixel layout of the texture type.
+    // all values are little endian.
+    class TextureContainer {
+    public:
+        struct Header {
+            TextureType textureType = TextureType::RGBA;
+            int width = 0;
+            int height = 0;
+            // level 0 and the reduced levels
+            int levels = 1;
+            bool premultipliedAlpha = false;
+            // offset of level 0 from the start of the file
+            int dataOffset = 0;
+            // bytes of all levels
+            int dataLength = 0;
+        };
+
+        static bool isContainer(string filename);
+        // "image.png" is stored as "image.mogtex"
+        static string getContainerName(string filename);
+        // returns false when the data is not a container, or is shorter than its levels.
+        static bool readHeader(const unsigned char *data, int len, Header *header);
+        static int getLevelOffset(const Header &header, int level);
+        // writes the pixels of the texture in its type. the reduced levels are stored when mipmap is set.
+        static bool write(const shared_ptr<Texture2D> &texture, string filepath, bool mipmap = false);
+    };
+}
+
+#endif /* TextureContainer_h */
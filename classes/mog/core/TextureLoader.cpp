@@ -0,0 +1,125 @@
+#include <chrono>
+#include <algorithm>
+#include "mog/Constants.h"
+#include "mog/core/TextureLoader.h"
+
+#define TEXTURE_UPLOAD_BUDGET 4.0f
+#define TEXTURE_LOADER_MAX_WORKERS 4
+
+using namespace mog;
+
+TextureLoader *TextureLoader::instance;
+
+TextureLoader *TextureLoader::getInstance() {
+    if (TextureLoader::instance == nullptr) {
+        TextureLoader::instance = new TextureLoader();
+    }
+    return TextureLoader::instance;
+}
+
+TextureLoader::TextureLoader() {
+    this->uploadBudget = TEXTURE_UPLOAD_BUDGET;
+}
+
+void TextureLoader::loadAsset(string filename, function<void(const shared_ptr<Texture2D> &texture)> callback) {
+    if (this->jobs.count(filename) > 0) {
+        this->jobs[filename]->callbacks.emplace_back(callback);
+        return;
+    }
+    auto job = make_shared<Job>();
+    job->filename = filename;
+    job->texture = make_shared<Texture2D>();
+    job->callbacks.emplace_back(callback);
+    this->jobs[filename] = job;
+
+    this->startWorkers();
+    {
+        lock_guard<mutex> lock(this->mtx);
+        this->decodeQueue.emplace_back(job);
+    }
+    this->condition.notify_one();
+}
+
+void TextureLoader::deliver(const shared_ptr<Texture2D> &texture, function<void(const shared_ptr<Texture2D> &texture)> callback) {
+    auto job = make_shared<Job>();
+    job->texture = texture;
+    job->callbacks.emplace_back(callback);
+    lock_guard<mutex> lock(this->mtx);
+    this->uploadQueue.emplace_back(job);
+}
+
+// at least one texture is uploaded per frame, so a slow upload never stalls the queue.
+void TextureLoader::uploadTextures() {
+    auto startTime = chrono::steady_clock::now();
+    while (true) {
+        shared_ptr<Job> job;
+        {
+            lock_guard<mutex> lock(this->mtx);
+            if (this->uploadQueue.empty()) break;
+            job = this->uploadQueue.front();
+            this->uploadQueue.pop_front();
+        }
+        if (job->filename.length() > 0) {
+            this->jobs.erase(job->filename);
+        }
+
+        // a cached texture composed into an atlas may have released its pixels without being uploaded
+        shared_ptr<Texture2D> texture = job->texture;
+        if (texture->textureId == 0) {
+            if (texture->loadData()) {
+                texture->bindTexture();
+            } else {
+                texture = nullptr;
+            }
+        }
+        for (const auto &callback : job->callbacks) {
+            if (callback) callback(texture);
+        }
+
+        auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime);
+        if (elapsed.count() / 1000.0f >= this->uploadBudget) break;
+    }
+}
+
+void TextureLoader::setUploadBudget(float millis) {
+    this->uploadBudget = millis;
+}
+
+float TextureLoader::getUploadBudget() {
+    return this->uploadBudget;
+}
+
+int TextureLoader::getPendingCount() {
+    return (int)this->jobs.size();
+}
+
+void TextureLoader::startWorkers() {
+    if (this->workers.size() > 0) return;
+
+    // one core is left to the render thread
+    int workersNum = (int)thread::hardware_concurrency() - 1;
+    workersNum = max(1, min(workersNum, TEXTURE_LOADER_MAX_WORKERS));
+    for (int i = 0; i < workersNum; i++) {
+        this->workers.emplace_back(thread([this]() {
+            this->runWorker();
+        }));
+        this->workers.back().detach();
+    }
+}
+
+void TextureLoader::runWorker() {
+    while (true) {
+        shared_ptr<Job> job;
+        {
+            unique_lock<mutex> lock(this->mtx);
+            this->condition.wait(lock, [this]() { return !this->decodeQueue.empty(); });
+            job = this->decodeQueue.front();
+            this->decodeQueue.pop_front();
+        }
+
+        job->texture->loadTextureAsset(job->filename);
+
+        lock_guard<mutex> lock(this->mtx);
+        this->uploadQueue.emplace_back(job);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef TextureLoader_h
+#define TextureLoader_h
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "mog/core/Texture2D.h"
+
+using namespace std;
+
+namespace mog {
+
+    // reads and decodes assets on a pool of worker threads.
+    // decoded textures are queued and uploaded on the render thread within a time budget per frame,
+    // then the callbacks are invoked there as well.
+    class TextureLoader {
+    public:
+        static TextureLoader *getInstance();
+
+        void loadAsset(string filename, function<void(const shared_ptr<Texture2D> &texture)> callback);
+        // delivers an already loaded texture in the same order as the decoded ones.
+        void deliver(const shared_ptr<Texture2D> &texture, function<void(const shared_ptr<Texture2D> &texture)> callback);
+        // called once per frame on the render thread.
+        void uploadTextures();
+
+        void setUploadBudget(float millis);
+        float getUploadBudget();
+        int getPendingCount();
+
+    private:
+        struct Job {
+            string filename;
+            shared_ptr<Texture2D> texture;
+            vector<function<void(const shared_ptr<Texture2D> &texture)>> callbacks;
+        };
+
+        static TextureLoader *instance;
+
+        // jobs by filename, to share one decode between requests of the same file. render thread only.
+        unordered_map<string, shared_ptr<Job>> jobs;
+        deque<shared_ptr<Job>> decodeQueue;
+        deque<shared_ptr<Job>> uploadQueue;
+        mutex mtx;
+        condition_variable condition;
+        vector<thread> workers;
+        float uploadBudget;
+
+        TextureLoader();
+        void startWorkers();
+        void runWorker();
+    };
+}
+
+#endif /* TextureLoader_h */
@@ -1,10 +1,32 @@
 #include "mog/core/FileUtilsNative.h"
 #include <QStandardPaths>
-#include <QFile>>
+#include <QFile>
+#include <QDirIterator>
+#include <unordered_map>
 
 using namespace mog;
 
+// the resource path of each listed asset. empty until the assets are listed.
+static unordered_map<string, QString> assetPaths;
+
+// a listed asset is opened from the root that holds it. before the assets are listed, the platform root is tried first.
+static bool openAsset(QFile &file, string filename) {
+    if (!assetPaths.empty()) {
+        auto it = assetPaths.find(filename);
+        if (it == assetPaths.end()) return false;
+        file.setFileName(it->second);
+        return file.open(QIODevice::ReadOnly);
+    }
+    file.setFileName(QString(":/assets_qt/%1").arg(filename.c_str()));
+    if (file.open(QIODevice::ReadOnly)) return true;
+    file.setFileName(QString(":/assets/%1").arg(filename.c_str()));
+    return file.open(QIODevice::ReadOnly);
+}
+
 bool FileUtilsNative::existAsset(string filename) {
+    if (!assetPaths.empty()) {
+        return assetPaths.count(filename) > 0;
+    }
     QString filenameStr = QString(":/assets_qt/%1").arg(filename.c_str());
     QFile file(filenameStr);
     if (file.exists()) return true;
@@ -15,13 +37,8 @@ bool FileUtilsNative::existAsset(string filename) {
 }
 
 string FileUtilsNative::readTextAsset(string filename) {
-    QString filenameStr = QString(":/assets_qt/%1").arg(filename.c_str());
-    QFile file(filenameStr);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QString filenameStr = QString(":/assets/%1").arg(filename.c_str());
-        QFile file(filenameStr);
-        if (!file.open(QIODevice::ReadOnly)) return "";
-    }
+    QFile file;
+    if (!openAsset(file, filename)) return "";
 
     QByteArray byteArr = file.readAll();
     string content = QString(byteArr).toStdString();
@@ -31,13 +48,8 @@ string FileUtilsNative::readTextAsset(string filename) {
 }
 
 bool FileUtilsNative::readBytesAsset(string filename, unsigned char **data, int *len) {
-    QString filenameStr = QString(":/assets_qt/%1").arg(filename.c_str());
-    QFile file(filenameStr);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QString filenameStr = QString(":/assets/%1").arg(filename.c_str());
-        QFile file(filenameStr);
-        if (!file.open(QIODevice::ReadOnly)) return "";
-    }
+    QFile file;
+    if (!openAsset(file, filename)) return false;
 
     QByteArray byteArr = file.readAll();
     *data = (unsigned char *)malloc(byteArr.size() * sizeof(unsigned char));
@@ -48,6 +60,46 @@ bool FileUtilsNative::readBytesAsset(string filename, unsigned char **data, int
     return true;
 }
 
+// the resource tree is in memory, so listing it does not touch the disk.
+// the platform assets shadow the common ones with the same name.
+bool FileUtilsNative::listAssets(vector<pair<string, int>> *assets) {
+    assetPaths.clear();
+    for (QString root : {QString(":/assets_qt/"), QString(":/assets/")}) {
+        QDirIterator it(root, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            QString path = it.next();
+            string name = path.mid(root.length()).toStdString();
+            if (assetPaths.count(name) > 0) continue;
+            assetPaths[name] = path;
+            assets->emplace_back(name, (int)it.fileInfo().size());
+        }
+    }
+    return true;
+}
+
+// resources stored without compression are mapped in place, the others can only be read.
+void *FileUtilsNative::mapAsset(string filename, const unsigned char **data, int *len) {
+    QFile *file = new QFile();
+    if (!openAsset(*file, filename)) {
+        delete file;
+        return nullptr;
+    }
+
+    uchar *mapped = file->map(0, file->size());
+    if (mapped == nullptr) {
+        delete file;
+        return nullptr;
+    }
+    *data = mapped;
+    *len = (int)file->size();
+    return file;
+}
+
+// closing the file unmaps it
+void FileUtilsNative::unmapAsset(void *handle) {
+    delete (QFile *)handle;
+}
+
 string FileUtilsNative::getDocumentsDirectory() {
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).toStdString();
 }
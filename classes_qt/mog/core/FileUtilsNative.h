@@ -2,6 +2,8 @@
 #define FileUtilsNative_h
 
 #include <string>
+#include <vector>
+#include <utility>
 
 using namespace std;
 
@@ -11,6 +13,11 @@ namespace mog {
         static bool existAsset(string filename);
         static string readTextAsset(string filename);
         static bool readBytesAsset(string filename, unsigned char **data, int *len);
+        // the relative path and the size of every asset. returns false when the platform cannot list them.
+        static bool listAssets(vector<pair<string, int>> *assets);
+        // returns the handle that keeps the mapping, or nullptr
+        static void *mapAsset(string filename, const unsigned char **data, int *len);
+        static void unmapAsset(void *handle);
         
         static string getDocumentsDirectory();
         static string getCachesDirectory();
@@ -1,7 +1,11 @@
 #ifndef opengl_h
 #define opengl_h
 
+#ifdef MOG_SOFTWARE_RENDERER
+#include "mog/core/SoftwareGL.h"
+#else
 #include <OpenGL/gl.h>
 #include <OpenGL/glext.h>
+#endif
 
 #endif /* opengl_h */
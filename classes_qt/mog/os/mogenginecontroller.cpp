@@ -6,6 +6,7 @@
 MogEngineController::MogEngineController() {
     this->app = make_shared<mog::App>();
     this->engine = mog::Engine::create(this->app);
+    this->engine->setDamageTrackingEnable(true);
 }
 
 void MogEngineController::startEngine() {
@@ -16,9 +17,10 @@ void MogEngineController::stopEngine() {
     this->engine->stopEngine();
 }
 
-void MogEngineController::drawFrame() {
+bool MogEngineController::drawFrame() {
     map<unsigned int, mog::TouchInput> touches;
     this->engine->onDrawFrame(touches);
+    return this->engine->isFrameDrawn();
 }
 
 void MogEngineController::resize(float width, float height) {
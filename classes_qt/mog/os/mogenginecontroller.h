@@ -16,7 +16,7 @@ public:
     void startEngine();
     void resize(float width, float height);
     void stopEngine();
-    void drawFrame();
+    bool drawFrame();
 
 private:
     std::shared_ptr<mog::Engine> engine;